@@ -0,0 +1,121 @@
+#include "allocation.hpp"
+
+#include <algorithm>
+
+#ifdef SATISFACTORY_COUNT_ALLOCATIONS
+#include <malloc.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace satisfactory {
+namespace {
+
+// The counts for each thread. This must be constant-initialized, as it is
+// used by operator new.
+struct ThreadCounts {
+  std::int64_t allocations = 0;
+  std::int64_t bytes = 0;
+  std::int64_t live = 0;
+  std::int64_t peak = 0;
+};
+
+thread_local constinit ThreadCounts thread_counts;
+
+}  // namespace
+
+AllocationScope::AllocationScope(AllocationCounts* counts) noexcept
+    : counts_(kCountAllocations ? counts : nullptr) {
+  if (!counts_) return;
+  allocations_ = thread_counts.allocations;
+  bytes_ = thread_counts.bytes;
+  live_ = thread_counts.live;
+  // Scopes may nest, so the peak of the enclosing scope is restored (and
+  // updated) when this one ends.
+  outer_peak_ = thread_counts.peak;
+  thread_counts.peak = live_;
+}
+
+AllocationScope::~AllocationScope() {
+  if (!counts_) return;
+  ThreadCounts& current = thread_counts;
+  counts_->allocations += current.allocations - allocations_;
+  counts_->bytes += current.bytes - bytes_;
+  counts_->peak = std::max(counts_->peak, current.peak - live_);
+  current.peak = std::max(current.peak, outer_peak_);
+}
+
+}  // namespace satisfactory
+
+#ifdef SATISFACTORY_COUNT_ALLOCATIONS
+
+// The replacement allocation functions. Sizes are taken from
+// malloc_usable_size so that deallocations can be accounted for without
+// a header in front of each allocation.
+
+namespace {
+
+void* Allocate(std::size_t size, std::size_t alignment) {
+  void* p = alignment <= alignof(std::max_align_t)
+                ? std::malloc(size ? size : 1)
+                : std::aligned_alloc(alignment,
+                                     (size + alignment - 1) / alignment *
+                                         alignment);
+  if (!p) return nullptr;
+  const std::int64_t bytes = malloc_usable_size(p);
+  satisfactory::thread_counts.allocations++;
+  satisfactory::thread_counts.bytes += bytes;
+  satisfactory::thread_counts.live += bytes;
+  satisfactory::thread_counts.peak = std::max(
+      satisfactory::thread_counts.peak, satisfactory::thread_counts.live);
+  return p;
+}
+
+void Deallocate(void* p) noexcept {
+  if (!p) return;
+  satisfactory::thread_counts.live -= malloc_usable_size(p);
+  std::free(p);
+}
+
+void* AllocateOrThrow(std::size_t size, std::size_t alignment) {
+  void* p = Allocate(size, alignment);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  return AllocateOrThrow(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size) {
+  return AllocateOrThrow(size, alignof(std::max_align_t));
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return AllocateOrThrow(size, std::size_t(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return AllocateOrThrow(size, std::size_t(alignment));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return Allocate(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return Allocate(size, alignof(std::max_align_t));
+}
+void operator delete(void* p) noexcept { Deallocate(p); }
+void operator delete[](void* p) noexcept { Deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { Deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { Deallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { Deallocate(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { Deallocate(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+  Deallocate(p);
+}
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+  Deallocate(p);
+}
+
+#endif  // SATISFACTORY_COUNT_ALLOCATIONS
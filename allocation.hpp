@@ -0,0 +1,44 @@
+#ifndef ALLOCATION_HPP_
+#define ALLOCATION_HPP_
+
+#include <cstdint>
+
+namespace satisfactory {
+
+// Heap allocations are only counted when the solver is built with the
+// COUNT_ALLOCATIONS CMake option, which replaces the global operator new and
+// operator delete. Otherwise, all counts remain zero.
+#ifdef SATISFACTORY_COUNT_ALLOCATIONS
+inline constexpr bool kCountAllocations = true;
+#else
+inline constexpr bool kCountAllocations = false;
+#endif
+
+struct AllocationCounts {
+  std::int64_t allocations = 0;
+  std::int64_t bytes = 0;
+  // The largest number of bytes that were live at once, beyond those that were
+  // already live when counting started.
+  std::int64_t peak = 0;
+};
+
+// Adds the allocations made by the current thread between its construction
+// and destruction to a set of counts, unless the counts are null. Memory freed
+// by a different thread than the one which allocated it is not accounted for
+// in the peak.
+class AllocationScope {
+ public:
+  explicit AllocationScope(AllocationCounts* counts) noexcept;
+  ~AllocationScope();
+
+  AllocationScope(const AllocationScope&) = delete;
+  AllocationScope& operator=(const AllocationScope&) = delete;
+
+ private:
+  AllocationCounts* counts_;
+  std::int64_t allocations_ = 0, bytes_ = 0, live_ = 0, outer_peak_ = 0;
+};
+
+}  // namespace satisfactory
+
+#endif  // ALLOCATION_HPP_
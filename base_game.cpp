@@ -0,0 +1,158 @@
+#include "base_game.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "parser.hpp"
+
+namespace satisfactory {
+namespace {
+
+struct File {
+  std::string_view path;
+  std::string_view source;
+};
+
+// The embedded files, which the build generates from BASE_GAME_FILES.
+constexpr File kFiles[] = {
+#include "base_game_files.inc"
+};
+
+// The file which the database is loaded from, as if it were given to the
+// solver. Its imports are looked up among the embedded files.
+constexpr std::string_view kMain = "building.txt";
+
+// Since this cannot be evaluated at compile time, an import of a file which is
+// not embedded fails the build.
+[[noreturn]] void MissingImport(std::string_view path) {
+  std::cerr << kMain << ": error: " << path << " is not embedded\n";
+  std::exit(1);
+}
+
+constexpr FlatInput ParseFile(std::string_view path) {
+  for (const auto& [name, source] : kFiles) {
+    if (name == path) return Parser(source, name).ParseInput<FlatInput>();
+  }
+  MissingImport(path);
+}
+
+// Appends the recipes and limits of the input's imports to the output in the
+// order of ModuleCache::Load, skipping any file which has already been visited.
+constexpr void AddImports(const FlatInput& input,
+                          std::vector<std::string_view>& visited,
+                          FlatInput& output) {
+  for (std::string_view path : input.imports) {
+    if (std::ranges::find(visited, path) != visited.end()) continue;
+    visited.push_back(path);
+    const FlatInput imported = ParseFile(path);
+    AddImports(imported, visited, output);
+    output.recipes.insert(output.recipes.end(), imported.recipes.begin(),
+                          imported.recipes.end());
+    output.limits.insert(output.limits.end(), imported.limits.begin(),
+                         imported.limits.end());
+  }
+}
+
+constexpr FlatInput Load() {
+  FlatInput input = ParseFile(kMain);
+  std::vector<std::string_view> visited = {kMain};
+  FlatInput imported;
+  AddImports(input, visited, imported);
+  imported.recipes.insert(imported.recipes.end(), input.recipes.begin(),
+                          input.recipes.end());
+  imported.limits.insert(imported.limits.end(), input.limits.begin(),
+                         input.limits.end());
+  input.recipes = std::move(imported.recipes);
+  input.limits = std::move(imported.limits);
+  return input;
+}
+
+// The size of each table, which must be known before the tables are built.
+struct Sizes {
+  int imports, recipes, items, demands, limits;
+};
+
+constexpr Sizes kSizes = [] {
+  const FlatInput input = Load();
+  int items = 0;
+  for (const FlatRecipe& recipe : input.recipes) {
+    items += recipe.inputs.size() + recipe.outputs.size();
+  }
+  return Sizes{.imports = int(input.imports.size()),
+               .recipes = int(input.recipes.size()),
+               .items = items,
+               .demands = int(input.demands.size()),
+               .limits = int(input.limits.size())};
+}();
+
+// Scenarios would need tables of their own.
+static_assert(Load().scenarios.empty());
+
+// A recipe whose inputs and outputs are the items [inputs, outputs) and
+// [outputs, end) of the item table.
+struct RecipeEntry {
+  int inputs, outputs, end;
+  Rational duration;
+  Rational cost;
+  std::optional<Rational> limit;
+};
+
+struct Tables {
+  std::array<std::string_view, kSizes.imports> imports;
+  std::array<RecipeEntry, kSizes.recipes> recipes;
+  std::array<std::pair<std::string_view, Rational>, kSizes.items> items;
+  std::array<Demand, kSizes.demands> demands;
+  std::array<Demand, kSizes.limits> limits;
+};
+
+constexpr Tables kTables = [] {
+  const FlatInput input = Load();
+  Tables tables = {};
+  std::ranges::copy(input.imports, tables.imports.begin());
+  int item = 0;
+  for (int i = 0; i < kSizes.recipes; i++) {
+    const FlatRecipe& recipe = input.recipes[i];
+    RecipeEntry& entry = tables.recipes[i];
+    entry.inputs = item;
+    for (const auto& pair : recipe.inputs) tables.items[item++] = pair;
+    entry.outputs = item;
+    for (const auto& pair : recipe.outputs) tables.items[item++] = pair;
+    entry.end = item;
+    entry.duration = recipe.duration;
+    entry.cost = recipe.cost;
+    entry.limit = recipe.limit;
+  }
+  std::ranges::copy(input.demands, tables.demands.begin());
+  std::ranges::copy(input.limits, tables.limits.begin());
+  return tables;
+}();
+
+}  // namespace
+
+const Input& BaseGame() {
+  // Only the maps of the recipes are built at run time.
+  static const Input input = [] {
+    Input input;
+    input.imports.assign(kTables.imports.begin(), kTables.imports.end());
+    for (const RecipeEntry& entry : kTables.recipes) {
+      const auto items = kTables.items.begin();
+      input.recipes.push_back(
+          Recipe{.inputs = {items + entry.inputs, items + entry.outputs},
+                 .outputs = {items + entry.outputs, items + entry.end},
+                 .duration = entry.duration,
+                 .cost = entry.cost,
+                 .limit = entry.limit});
+    }
+    input.demands.assign(kTables.demands.begin(), kTables.demands.end());
+    input.limits.assign(kTables.limits.begin(), kTables.limits.end());
+    return input;
+  }();
+  return input;
+}
+
+}  // namespace satisfactory
@@ -0,0 +1,16 @@
+#ifndef BASE_GAME_HPP_
+#define BASE_GAME_HPP_
+
+#include "data.hpp"
+
+namespace satisfactory {
+
+// The base game database: building.txt and the recipes.txt which it imports,
+// embedded in the binary and parsed when it is compiled. The result is the
+// same as loading building.txt through a ModuleCache, but no file is read or
+// parsed at run time. Every string_view refers to static storage.
+const Input& BaseGame();
+
+}  // namespace satisfactory
+
+#endif  // BASE_GAME_HPP_
@@ -0,0 +1,54 @@
+#include "basis.hpp"
+
+#include <fstream>
+#include <sstream>
+
+#include "serialize.hpp"
+
+namespace satisfactory {
+
+std::string RecipeKey(const Recipe& recipe) {
+  std::ostringstream output;
+  output << recipe;
+  return output.str();
+}
+
+// The file is line based, with a header line for each scenario:
+//
+//   [<scenario name>]
+//   resource <name>
+//   recipe <recipe text>
+BasisSet LoadBases(const std::filesystem::path& path) {
+  BasisSet bases;
+  std::ifstream file(path);
+  Basis* basis = nullptr;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.starts_with('[') && line.ends_with(']')) {
+      basis = &bases[line.substr(1, line.size() - 2)];
+    } else if (basis && line.starts_with("resource ")) {
+      basis->resources.push_back(line.substr(9));
+    } else if (basis && line.starts_with("recipe ")) {
+      basis->recipes.push_back(line.substr(7));
+    } else if (!line.empty()) {
+      return {};
+    }
+  }
+  return bases;
+}
+
+bool SaveBases(const std::filesystem::path& path, const BasisSet& bases) {
+  std::ostringstream output;
+  for (const auto& [name, basis] : bases) {
+    output << '[' << name << "]\n";
+    for (const std::string& resource : basis.resources) {
+      output << "resource " << resource << '\n';
+    }
+    for (const std::string& recipe : basis.recipes) {
+      output << "recipe " << recipe << '\n';
+    }
+  }
+  return WriteFileAtomically(path, output.str());
+}
+
+}  // namespace satisfactory
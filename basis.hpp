@@ -0,0 +1,38 @@
+#ifndef BASIS_HPP_
+#define BASIS_HPP_
+
+#include "data.hpp"
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace satisfactory {
+
+// The set of basic variables of an optimal tableau. Variables are identified by
+// name rather than by column, so that a basis can be carried over to a later
+// run in which recipes or resources have been added, removed or reordered.
+struct Basis {
+  // Resources whose dual variable is basic.
+  std::vector<std::string> resources;
+  // Recipes whose slack variable is basic, identified by RecipeKey.
+  std::vector<std::string> recipes;
+};
+
+// Identifies a recipe by its full text, so that any edit to a recipe gives it
+// a new identity.
+std::string RecipeKey(const Recipe& recipe);
+
+// Bases for each scenario of an input file, keyed by scenario name. The
+// top-level demands of a file use the empty name.
+using BasisSet = std::map<std::string, Basis>;
+
+// Reads a basis file. A missing or malformed file yields an empty set, since
+// bases are only ever used as hints.
+BasisSet LoadBases(const std::filesystem::path& path);
+bool SaveBases(const std::filesystem::path& path, const BasisSet& bases);
+
+}  // namespace satisfactory
+
+#endif  // BASIS_HPP_
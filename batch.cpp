@@ -0,0 +1,57 @@
+#include "batch.hpp"
+
+#include <cassert>
+
+#include "solver.hpp"
+#include "table.hpp"
+#include "thread_pool.hpp"
+
+namespace satisfactory {
+
+std::vector<std::optional<Solution>> SolveScenarios(const Input& input,
+                                                    const SolveOptions& options,
+                                                    int num_threads) {
+  const std::vector<SolveOptions> shared(input.scenarios.size(), options);
+  return SolveScenarios(input, shared, num_threads);
+}
+
+std::vector<std::optional<Solution>> SolveScenarios(
+    const Input& input, std::span<const SolveOptions> options,
+    int num_threads) {
+  std::vector<std::optional<Solution>> solutions(input.scenarios.size());
+  // Each scenario writes only to its own slot, so no further synchronization
+  // is required.
+  SolveScenarios(
+      input, options,
+      [&](int i, std::optional<Solution> solution) {
+        solutions[i] = std::move(solution);
+      },
+      num_threads);
+  return solutions;
+}
+
+void SolveScenarios(
+    const Input& input, std::span<const SolveOptions> options,
+    const std::function<void(int, std::optional<Solution>)>& on_solved,
+    int num_threads) {
+  const int n = input.scenarios.size();
+  assert(int(options.size()) == n);
+  // The scenarios share the recipes, so their tableaus are of similar sizes,
+  // and each one reuses the memory of those which were solved before it.
+  TablePool pool;
+  // The recipes are shared read-only between the threads.
+  ParallelFor(
+      n,
+      [&](int i) {
+        if (options[i].pool) {
+          on_solved(i, Solve(input, input.scenarios[i].demands, options[i]));
+          return;
+        }
+        SolveOptions pooled = options[i];
+        pooled.pool = &pool;
+        on_solved(i, Solve(input, input.scenarios[i].demands, pooled));
+      },
+      num_threads);
+}
+
+}  // namespace satisfactory
@@ -0,0 +1,35 @@
+#ifndef BATCH_HPP_
+#define BATCH_HPP_
+
+#include "data.hpp"
+#include "solver.hpp"
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace satisfactory {
+
+// Solves every scenario of the input, distributing them across up to
+// num_threads threads (one per hardware thread by default). The result at index
+// i is the solution for input.scenarios[i].
+std::vector<std::optional<Solution>> SolveScenarios(
+    const Input& input, const SolveOptions& options = {}, int num_threads = 0);
+
+// As above, but options[i] is used to solve input.scenarios[i].
+std::vector<std::optional<Solution>> SolveScenarios(
+    const Input& input, std::span<const SolveOptions> options,
+    int num_threads = 0);
+
+// Solves every scenario as above, but rather than collecting the solutions,
+// calls on_solved(i, solution) for scenario i as soon as it has been solved.
+// Calls are made concurrently from the solving threads, in no particular order.
+void SolveScenarios(
+    const Input& input, std::span<const SolveOptions> options,
+    const std::function<void(int, std::optional<Solution>)>& on_solved,
+    int num_threads = 0);
+
+}  // namespace satisfactory
+
+#endif  // BATCH_HPP_
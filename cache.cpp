@@ -0,0 +1,188 @@
+#include "cache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+
+#include "hash.hpp"
+#include "serialize.hpp"
+
+namespace satisfactory {
+namespace {
+
+// Bumped whenever the encoding of a cached solution changes.
+constexpr std::uint64_t kSolutionMagic = 0x31'4c4f'5354'4153;  // "SATSOL1"
+
+std::filesystem::path CacheFile(const std::filesystem::path& directory,
+                                std::uint64_t hash) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.solution",
+                static_cast<unsigned long long>(hash));
+  return directory / name;
+}
+
+std::string EncodeSolution(std::string_view key,
+                           const CachedSolution& solution) {
+  Writer writer;
+  writer.WriteU64(kSolutionMagic);
+  writer.WriteString(key);
+  writer.WriteU32(solution.uses.size());
+  for (const Rational& x : solution.uses) writer.WriteRational(x);
+  writer.WriteRational(solution.cost);
+  return std::move(writer.buffer());
+}
+
+std::optional<CachedSolution> DecodeSolution(std::string_view data,
+                                             std::string_view key) {
+  Reader reader(data);
+  if (reader.ReadU64() != kSolutionMagic) return std::nullopt;
+  // The full key is stored alongside the solution, so hash collisions are
+  // detected rather than returning the solution to a different problem.
+  if (reader.ReadString() != key) return std::nullopt;
+  CachedSolution solution;
+  const std::uint32_t n = reader.ReadU32();
+  if (n > data.size()) return std::nullopt;
+  solution.uses.reserve(n);
+  for (std::uint32_t i = 0; i < n; i++) {
+    solution.uses.push_back(reader.ReadRational());
+  }
+  solution.cost = reader.ReadRational();
+  if (!reader.ok() || !reader.empty()) return std::nullopt;
+  return solution;
+}
+
+}  // namespace
+
+CanonicalProblem Canonicalize(const Input& input,
+                              std::span<const Demand> demands) {
+  const std::vector<std::string_view> resources = Resources(input, demands);
+  const auto column = [&](std::string_view name) -> std::uint32_t {
+    return std::ranges::lower_bound(resources, name) - resources.begin();
+  };
+  // Each recipe is reduced to its rates per second, which is all that the
+  // solver depends upon.
+  const int r = input.recipes.size();
+  std::vector<std::string> recipes(r);
+  for (int i = 0; i < r; i++) {
+    const Recipe& recipe = input.recipes[i];
+    Writer writer;
+    for (const auto* rates : {&recipe.inputs, &recipe.outputs}) {
+      writer.WriteU32(rates->size());
+      for (const auto& [resource, quantity] : *rates) {
+        writer.WriteU32(column(resource));
+        writer.WriteRational(quantity / recipe.duration);
+      }
+    }
+    writer.WriteRational(recipe.cost);
+    writer.WriteU32(recipe.limit.has_value());
+    if (recipe.limit) writer.WriteRational(*recipe.limit);
+    recipes[i] = std::move(writer.buffer());
+  }
+  CanonicalProblem problem;
+  problem.order.resize(r);
+  std::iota(problem.order.begin(), problem.order.end(), 0);
+  std::ranges::stable_sort(problem.order, std::less<>(),
+                           [&](int i) -> const std::string& {
+                             return recipes[i];
+                           });
+  Writer writer;
+  writer.WriteU32(resources.size());
+  for (std::string_view resource : resources) writer.WriteString(resource);
+  writer.WriteU32(r);
+  for (int i : problem.order) writer.WriteString(recipes[i]);
+  // Demands for the same resource add up, as they do in the solver.
+  std::map<std::uint32_t, Rational> rates;
+  for (const auto& [name, rate] : demands) rates[column(name)] += rate;
+  writer.WriteU32(rates.size());
+  for (const auto& [resource, rate] : rates) {
+    writer.WriteU32(resource);
+    writer.WriteRational(rate);
+  }
+  // Only the tightest limit on each resource matters. Limits may name resources
+  // which no recipe produces, so they are keyed by name.
+  std::map<std::string_view, Rational> limits;
+  for (const auto& [name, rate] : input.limits) {
+    const auto [i, inserted] = limits.emplace(name, rate);
+    if (!inserted) i->second = std::min(i->second, rate);
+  }
+  writer.WriteU32(limits.size());
+  for (const auto& [name, rate] : limits) {
+    writer.WriteString(name);
+    writer.WriteRational(rate);
+  }
+  problem.key = std::move(writer.buffer());
+  problem.hash = Fnv1a(problem.key);
+  return problem;
+}
+
+std::size_t SolutionCache::KeyHash::operator()(
+    std::string_view key) const noexcept {
+  return Fnv1a(key);
+}
+
+SolutionCache::SolutionCache(std::size_t capacity,
+                             std::filesystem::path directory)
+    : capacity_(capacity), directory_(std::move(directory)) {}
+
+std::optional<CachedSolution> SolutionCache::Lookup(
+    const CanonicalProblem& problem) {
+  std::unique_lock lock(mutex_);
+  if (auto i = index_.find(problem.key); i != index_.end()) {
+    entries_.splice(entries_.begin(), entries_, i->second);
+    stats_.hits++;
+    return i->second->solution;
+  }
+  if (!directory_.empty()) {
+    std::ifstream file(CacheFile(directory_, problem.hash), std::ios::binary);
+    if (file) {
+      const std::string data(std::istreambuf_iterator<char>(file), {});
+      if (std::optional<CachedSolution> solution =
+              DecodeSolution(data, problem.key)) {
+        stats_.hits++;
+        stats_.disk_hits++;
+        Add(problem.key, *solution);
+        return solution;
+      }
+    }
+  }
+  stats_.misses++;
+  return std::nullopt;
+}
+
+void SolutionCache::Insert(const CanonicalProblem& problem,
+                           const CachedSolution& solution) {
+  std::unique_lock lock(mutex_);
+  if (index_.contains(problem.key)) return;
+  Add(problem.key, solution);
+  if (directory_.empty()) return;
+  WriteFileAtomically(CacheFile(directory_, problem.hash),
+                      EncodeSolution(problem.key, solution));
+}
+
+SolutionCacheStats SolutionCache::stats() const {
+  std::unique_lock lock(mutex_);
+  return stats_;
+}
+
+void SolutionCache::Add(std::string key, const CachedSolution& solution) {
+  if (capacity_ == 0) return;
+  entries_.push_front(Entry{.key = std::move(key), .solution = solution});
+  index_.emplace(entries_.front().key, entries_.begin());
+  while (entries_.size() > capacity_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+    stats_.evictions++;
+  }
+}
+
+std::ostream& operator<<(std::ostream& output,
+                         const SolutionCacheStats& stats) {
+  return output << "Solution cache: " << stats.hits << " hits ("
+                << stats.disk_hits << " from disk), " << stats.misses
+                << " misses, " << stats.evictions << " evictions";
+}
+
+}  // namespace satisfactory
@@ -0,0 +1,87 @@
+#ifndef CACHE_HPP_
+#define CACHE_HPP_
+
+#include "data.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace satisfactory {
+
+// A canonical encoding of a problem. Two problems have the same key exactly
+// when they have the same recipes (up to order, and up to scaling the
+// quantities and duration of a recipe together) and the same demands.
+struct CanonicalProblem {
+  std::string key;
+  std::uint64_t hash;
+  // order[k] is the index in input.recipes of the k'th recipe in canonical
+  // order.
+  std::vector<int> order;
+};
+
+CanonicalProblem Canonicalize(const Input& input,
+                              std::span<const Demand> demands);
+
+// The parts of a solution which cannot be cheaply recomputed, with the uses
+// given in canonical recipe order.
+struct CachedSolution {
+  std::vector<Rational> uses;
+  Rational cost;
+};
+
+struct SolutionCacheStats {
+  std::int64_t hits = 0;
+  std::int64_t misses = 0;
+  std::int64_t evictions = 0;
+  // Hits which were served from the cache directory rather than from memory.
+  std::int64_t disk_hits = 0;
+};
+
+// A content-addressed cache of solutions. Solutions are kept in memory in
+// least-recently-used order and, if a directory is given, are also persisted
+// there in a compact binary encoding. The cache is safe to use from multiple
+// threads.
+class SolutionCache {
+ public:
+  explicit SolutionCache(std::size_t capacity,
+                         std::filesystem::path directory = {});
+
+  std::optional<CachedSolution> Lookup(const CanonicalProblem& problem);
+  void Insert(const CanonicalProblem& problem, const CachedSolution& solution);
+
+  SolutionCacheStats stats() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    CachedSolution solution;
+  };
+  struct KeyHash {
+    std::size_t operator()(std::string_view key) const noexcept;
+  };
+
+  // Inserts an entry in memory. The mutex must be held.
+  void Add(std::string key, const CachedSolution& solution);
+
+  const std::size_t capacity_;
+  const std::filesystem::path directory_;
+  mutable std::mutex mutex_;
+  // Most recently used entries are at the front.
+  std::list<Entry> entries_;
+  std::unordered_map<std::string_view, std::list<Entry>::iterator, KeyHash>
+      index_;
+  SolutionCacheStats stats_;
+};
+
+std::ostream& operator<<(std::ostream&, const SolutionCacheStats&);
+
+}  // namespace satisfactory
+
+#endif  // CACHE_HPP_
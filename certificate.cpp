@@ -0,0 +1,142 @@
+#include "certificate.hpp"
+
+#include <sstream>
+
+namespace satisfactory {
+namespace {
+
+// Formats a description of a failed condition.
+template <typename... Args>
+std::string Describe(const Args&... args) {
+  std::ostringstream output;
+  (output << ... << args);
+  return output.str();
+}
+
+}  // namespace
+
+std::optional<std::string> CheckCertificate(const Input& input,
+                                            std::span<const Demand> demands,
+                                            const Solution& solution,
+                                            const Certificate& certificate) {
+  const int r = input.recipes.size();
+  const int num_limits = input.limits.size();
+  if (std::ssize(solution.uses) != r) return "the number of uses is wrong";
+  if (!certificate.recipe_limits.empty() &&
+      std::ssize(certificate.recipe_limits) != r) {
+    return "the number of recipe limits is wrong";
+  }
+  if (!certificate.resource_limits.empty() &&
+      std::ssize(certificate.resource_limits) != num_limits) {
+    return "the number of resource limits is wrong";
+  }
+  for (const auto& [resource, price] : certificate.prices) {
+    if (price < 0) return Describe("the price of ", resource, " is negative");
+  }
+  // The savings of the limits on each resource, which every unit/min of its
+  // production counts towards.
+  std::map<std::string_view, Rational> savings;
+  for (int l = 0; l < num_limits; l++) {
+    if (certificate.resource_limits.empty()) break;
+    const Rational& saving = certificate.resource_limits[l];
+    if (saving < 0) {
+      return Describe("the saving of the limit on ", input.limits[l].name,
+                      " is negative");
+    }
+    if (saving != 0) savings[input.limits[l].name] += saving;
+  }
+  const auto find = [](const std::map<std::string_view, Rational>& map,
+                       std::string_view key) {
+    const auto i = map.find(key);
+    return i == map.end() ? Rational(0) : i->second;
+  };
+  // The net production and the production of each resource, in units/min.
+  std::map<std::string_view, Rational> net, produced;
+  Rational cost = 0;
+  std::map<std::string_view, Rational> quantities;
+  for (int i = 0; i < r; i++) {
+    const Recipe& recipe = input.recipes[i];
+    const Rational& use = solution.uses[i];
+    if (use < 0) return Describe("recipe ", i, " is used a negative amount");
+    cost += recipe.cost * use;
+    Rational reduced_cost = recipe.cost;
+    if (!certificate.recipe_limits.empty()) {
+      const Rational& saving = certificate.recipe_limits[i];
+      if (saving < 0) {
+        return Describe("the saving of the limit on recipe ", i,
+                        " is negative");
+      }
+      if (saving != 0) {
+        if (!recipe.limit) {
+          return Describe("recipe ", i, " has a saving but no limit");
+        }
+        if (use != *recipe.limit) {
+          return Describe("recipe ", i, " has a saving but its limit is slack");
+        }
+      }
+      reduced_cost += saving;
+    }
+    if (recipe.limit && use > *recipe.limit) {
+      return Describe("recipe ", i, " is used beyond its limit");
+    }
+    // A resource can be both an input and an output of the same recipe, in
+    // which case only the difference matters, as in the solver.
+    quantities.clear();
+    for (const auto& [resource, quantity] : recipe.inputs) {
+      quantities[resource] -= quantity;
+    }
+    for (const auto& [resource, quantity] : recipe.outputs) {
+      quantities[resource] += quantity;
+    }
+    for (const auto& [resource, quantity] : quantities) {
+      const Rational rate = 60 * quantity / recipe.duration;
+      net[resource] += rate * use;
+      reduced_cost -= find(certificate.prices, resource) * rate;
+      if (rate > 0) {
+        produced[resource] += rate * use;
+        reduced_cost += find(savings, resource) * rate;
+      }
+    }
+    if (reduced_cost < 0) {
+      return Describe("recipe ", i, " has a negative reduced cost");
+    }
+    if (use > 0 && reduced_cost != 0) {
+      return Describe("recipe ", i, " is used but has a reduced cost");
+    }
+  }
+  if (cost != solution.cost) return "the cost does not match the uses";
+  std::map<std::string_view, Rational> demanded;
+  for (const auto& [resource, units_per_minute] : demands) {
+    demanded[resource] += units_per_minute;
+  }
+  for (const auto& [resource, units_per_minute] : demanded) {
+    if (find(net, resource) < units_per_minute) {
+      return Describe("the demand for ", resource, " is not met");
+    }
+  }
+  for (const auto& [resource, rate] : net) {
+    if (rate < find(demanded, resource)) {
+      return Describe("more ", resource, " is used than is produced");
+    }
+  }
+  for (const auto& [resource, price] : certificate.prices) {
+    if (price != 0 && find(net, resource) != find(demanded, resource)) {
+      return Describe(resource, " has a price but is overproduced");
+    }
+  }
+  for (int l = 0; l < num_limits; l++) {
+    const auto& [resource, units_per_minute] = input.limits[l];
+    const Rational production = find(produced, resource);
+    if (production > units_per_minute) {
+      return Describe("the limit on ", resource, " is exceeded");
+    }
+    if (!certificate.resource_limits.empty() &&
+        certificate.resource_limits[l] != 0 && production != units_per_minute) {
+      return Describe("the limit on ", resource,
+                      " has a saving but is slack");
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace satisfactory
@@ -0,0 +1,58 @@
+#ifndef CERTIFICATE_HPP_
+#define CERTIFICATE_HPP_
+
+#include "data.hpp"
+
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace satisfactory {
+
+// The values of the dual problem which prove a solution optimal. Each value is
+// the marginal cost of a constraint of the primal problem, in the units of the
+// input, and is never negative.
+struct Certificate {
+  // The price of each resource per unit/min, which is its marginal cost as in
+  // Sensitivity::prices. Resources which are not listed have no price.
+  std::map<std::string_view, Rational> prices;
+  // recipe_limits[i] is how much the cost would fall for each extra use
+  // allowed by the limit of input->recipes[i]. Either empty, for no savings,
+  // or one per recipe.
+  std::vector<Rational> recipe_limits;
+  // resource_limits[l] is how much the cost would fall for each extra unit/min
+  // allowed by input->limits[l]. Either empty, for no savings, or one per
+  // limit.
+  std::vector<Rational> resource_limits;
+};
+
+// Checks exactly that the solution is optimal for the demands, without solving
+// the problem again, by checking that:
+//
+//   * The solution is feasible: no recipe is used a negative amount, the net
+//     production of each resource meets its demand, and no limit is exceeded.
+//   * The certificate is feasible for the dual problem: no recipe has a
+//     negative reduced cost, which is its cost less the value of its net
+//     production at the prices, plus the savings of the limits which it counts
+//     towards.
+//   * Complementary slackness holds: recipes which are used have no reduced
+//     cost, resources with a price are produced exactly as demanded, and
+//     limits with savings are met exactly. Along with feasibility, this means
+//     that no solution is cheaper.
+//   * The cost of the solution is the cost of its recipe uses.
+//
+// This takes time linear in the size of the input, so it is much cheaper than
+// solving the problem, and does not trust any of the solver's fast paths.
+// Returns a description of the first condition which does not hold, or
+// std::nullopt if the solution is proven optimal.
+std::optional<std::string> CheckCertificate(const Input& input,
+                                            std::span<const Demand> demands,
+                                            const Solution& solution,
+                                            const Certificate& certificate);
+
+}  // namespace satisfactory
+
+#endif  // CERTIFICATE_HPP_
@@ -1,8 +1,11 @@
 #include "data.hpp"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
+#include "trace.hpp"
+
 namespace satisfactory {
 namespace {
 
@@ -27,12 +30,75 @@ std::ostream& operator<<(std::ostream& output, ResourceList list) {
   return output;
 }
 
+// Writes the end of a range in a column, with unbounded ends as infinities.
+void PrintEnd(std::ostream& output, const std::optional<Rational>& end,
+              std::string_view infinity) {
+  output << std::setw(12);
+  if (end) {
+    output << *end;
+  } else {
+    output << infinity;
+  }
+}
+
+void PrintSensitivity(std::ostream& output, const Sensitivity& sensitivity,
+                      std::span<const Recipe> recipes) {
+  output << "Marginal Costs (per unit/min):\n\n";
+  output << std::setw(12) << "Cost" << '\t' << "Resource\n";
+  for (const auto& [name, price] : sensitivity.prices) {
+    if (price != 0) {
+      output << "  " << std::setw(10) << price << '\t' << name << '\n';
+    }
+  }
+  output << "\nDemand Ranges (units/min):\n\n";
+  output << std::setw(12) << "From" << std::setw(12) << "To" << '\t'
+         << "Resource\n";
+  for (const auto& [name, range] : sensitivity.demand_ranges) {
+    PrintEnd(output, range.lower, "-inf");
+    PrintEnd(output, range.upper, "inf");
+    output << '\t' << name << '\n';
+  }
+  output << "\nRecipe Costs:\n\n";
+  output << std::setw(12) << "Reduced" << std::setw(12) << "From"
+         << std::setw(12) << "To" << '\t' << "Recipe\n";
+  for (std::size_t i = 0; i < recipes.size(); i++) {
+    const Range& range = sensitivity.cost_ranges[i];
+    output << std::setw(12) << sensitivity.reduced_costs[i];
+    PrintEnd(output, range.lower, "-inf");
+    PrintEnd(output, range.upper, "inf");
+    output << '\t' << recipes[i] << '\n';
+  }
+}
+
 }  // namespace
 
+std::vector<std::string_view> Resources(const Input& input,
+                                        std::span<const Demand> demands) {
+  std::vector<std::string_view> result;
+  for (const auto& recipe : input.recipes) {
+    for (const auto& [resource, quantity] : recipe.inputs) {
+      result.push_back(resource);
+    }
+    for (const auto& [resource, quantity] : recipe.outputs) {
+      result.push_back(resource);
+    }
+  }
+  for (const auto& [name, rate] : demands) {
+    result.push_back(name);
+  }
+  std::ranges::sort(result);
+  auto [first, last] = std::ranges::unique(result);
+  result.erase(first, last);
+  result.shrink_to_fit();
+  return result;
+}
+
 std::ostream& operator<<(std::ostream& output, const Recipe& recipe) {
-  return output << ResourceList(recipe.inputs) << " -> "
-                << ResourceList(recipe.outputs) << " (" << recipe.duration
-                << " s/run, cost " << recipe.cost << ')';
+  output << ResourceList(recipe.inputs) << " -> "
+         << ResourceList(recipe.outputs) << " (" << recipe.duration
+         << " s/run, cost " << recipe.cost;
+  if (recipe.limit) output << ", max " << *recipe.limit;
+  return output << ')';
 }
 
 std::ostream& operator<<(std::ostream& output, const Demand& demand) {
@@ -40,11 +106,28 @@ std::ostream& operator<<(std::ostream& output, const Demand& demand) {
                 << " units/min)";
 }
 
+std::ostream& operator<<(std::ostream& output, const Scenario& scenario) {
+  output << '[' << scenario.name << "]\n";
+  for (const auto& demand : scenario.demands) {
+    output << "  " << demand << '\n';
+  }
+  return output;
+}
+
 std::ostream& operator<<(std::ostream& output, const Input& input) {
+  for (std::string_view path : input.imports) {
+    output << "Import " << path << '\n';
+  }
+  for (const auto& limit : input.limits) {
+    output << "Limit " << limit << '\n';
+  }
   output << "Produce:\n";
   for (const auto& demand : input.demands) {
     output << "  " << demand << '\n';
   }
+  for (const auto& scenario : input.scenarios) {
+    output << scenario;
+  }
   output << "Using:\n";
   for (const auto& recipe : input.recipes) {
     output << "  " << recipe << '\n';
@@ -54,6 +137,7 @@ std::ostream& operator<<(std::ostream& output, const Input& input) {
 }
 
 std::ostream& operator<<(std::ostream& output, const Solution& solution) {
+  const TraceSpan span("FormatSolution");
   output << "Recipe Uses:\n\n";
   output << std::setw(12) << "Machines" << '\t' << "Recipe\n";
   const int r = solution.input->recipes.size();
@@ -78,6 +162,10 @@ std::ostream& operator<<(std::ostream& output, const Solution& solution) {
     }
   }
   output << "\nFor a total cost of " << solution.cost;
+  if (solution.sensitivity) {
+    output << "\n\n";
+    PrintSensitivity(output, *solution.sensitivity, solution.input->recipes);
+  }
   return output;
 }
 
@@ -5,6 +5,8 @@
 
 #include <iosfwd>
 #include <map>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -14,6 +16,8 @@ struct Recipe {
   std::map<std::string_view, Rational> inputs, outputs;
   Rational duration;
   Rational cost;
+  // If set, the most that this recipe may be used.
+  std::optional<Rational> limit;
 };
 
 struct Demand {
@@ -21,9 +25,46 @@ struct Demand {
   Rational units_per_minute;
 };
 
+// A named set of demands which is solved against the shared recipe list.
+struct Scenario {
+  std::string_view name;
+  std::vector<Demand> demands;
+};
+
 struct Input {
+  // Paths named by import directives, in the order that they appear.
+  std::vector<std::string_view> imports;
   std::vector<Recipe> recipes;
+  // Demands which are not part of any named scenario.
   std::vector<Demand> demands;
+  std::vector<Scenario> scenarios;
+  // Upper bounds on the total production of resources, such as the ore which
+  // can be extracted from a limited number of resource nodes. These apply to
+  // the top-level demands and to every scenario.
+  std::vector<Demand> limits;
+};
+
+// A range of values, where a missing end is unbounded.
+struct Range {
+  std::optional<Rational> lower, upper;
+};
+
+// How the optimal solution responds to changes in the problem, read from the
+// final tableau rather than found by solving the problem again.
+struct Sensitivity {
+  // The marginal cost of each resource: how much the total cost rises for each
+  // extra unit/min of it that is demanded.
+  std::map<std::string_view, Rational> prices;
+  // reduced_costs[i] is how much cheaper input->recipes[i] would have to be for
+  // using it to reduce the total cost, which is zero for the recipes in use.
+  std::vector<Rational> reduced_costs;
+  // The range of units/min over which each demand can vary with the prices
+  // staying the same, although the recipe uses change.
+  std::map<std::string_view, Range> demand_ranges;
+  // cost_ranges[i] is the range over which the cost of input->recipes[i] can
+  // vary with the recipe uses staying the same, although the total cost
+  // changes. Costs cannot be negative, so no range extends below zero.
+  std::vector<Range> cost_ranges;
 };
 
 struct Solution {
@@ -38,10 +79,18 @@ struct Solution {
   std::map<std::string_view, Rational> total, net;
   // The total cost of this solution.
   Rational cost;
+  // Only set if requested (see SolveOptions::sensitivity).
+  std::optional<Sensitivity> sensitivity;
 };
 
+// Retrieves a sorted list of all resources referenced by recipes or demands.
+// The order of this list determines the column order of the solver's tableau.
+std::vector<std::string_view> Resources(const Input& input,
+                                        std::span<const Demand> demands);
+
 std::ostream& operator<<(std::ostream&, const Recipe&);
 std::ostream& operator<<(std::ostream&, const Demand&);
+std::ostream& operator<<(std::ostream&, const Scenario&);
 std::ostream& operator<<(std::ostream&, const Input&);
 std::ostream& operator<<(std::ostream&, const Solution&);
 
@@ -0,0 +1,83 @@
+#include "decompose.hpp"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <utility>
+
+namespace satisfactory {
+namespace {
+
+// A disjoint-set forest over resource indices.
+class DisjointSets {
+ public:
+  explicit DisjointSets(int n) : parent_(n) {
+    std::iota(parent_.begin(), parent_.end(), 0);
+  }
+
+  int Find(int x) {
+    while (parent_[x] != x) x = parent_[x] = parent_[parent_[x]];
+    return x;
+  }
+
+  void Union(int x, int y) { parent_[Find(x)] = Find(y); }
+
+ private:
+  std::vector<int> parent_;
+};
+
+}  // namespace
+
+std::vector<Block> Decompose(const Input& input,
+                             std::span<const Demand> demands) {
+  const std::vector<std::string_view> resources = Resources(input, demands);
+  const auto index = [&](std::string_view name) -> int {
+    return std::ranges::lower_bound(resources, name) - resources.begin();
+  };
+  const int n = resources.size();
+  const int r = input.recipes.size();
+  // The non-zero net quantities of each recipe. Resources with a zero net
+  // quantity, such as (ResourceNode), do not connect recipes in the tableau.
+  std::vector<std::vector<std::pair<int, Rational>>> net(r);
+  for (int i = 0; i < r; i++) {
+    std::map<int, Rational> quantities;
+    for (const auto& [resource, quantity] : input.recipes[i].inputs) {
+      quantities[index(resource)] -= quantity;
+    }
+    for (const auto& [resource, quantity] : input.recipes[i].outputs) {
+      quantities[index(resource)] += quantity;
+    }
+    for (const auto& [resource, quantity] : quantities) {
+      if (quantity != 0) net[i].push_back({resource, quantity});
+    }
+  }
+  DisjointSets sets(n);
+  for (int i = 0; i < r; i++) {
+    for (const auto& [resource, quantity] : net[i]) {
+      sets.Union(net[i].front().first, resource);
+    }
+  }
+  // Blocks are keyed by the representative of their resources.
+  std::map<int, Block> blocks;
+  for (int i = 0; i < r; i++) {
+    if (net[i].empty()) continue;
+    blocks[sets.Find(net[i].front().first)].recipes.push_back(i);
+  }
+  for (const Demand& demand : demands) {
+    blocks[sets.Find(index(demand.name))].demands.push_back(demand);
+  }
+  std::vector<Block> result;
+  for (auto& [key, block] : blocks) {
+    // Recipes which cannot reach any demand would never be used.
+    if (block.demands.empty() || block.recipes.empty()) continue;
+    result.push_back(std::move(block));
+  }
+  // Order the blocks by their first recipe, so that the order does not depend
+  // on the representatives chosen by the disjoint-set forest.
+  std::ranges::sort(result, {}, [](const Block& block) {
+    return block.recipes.front();
+  });
+  return result;
+}
+
+}  // namespace satisfactory
@@ -0,0 +1,35 @@
+#ifndef DECOMPOSE_HPP_
+#define DECOMPOSE_HPP_
+
+#include "data.hpp"
+
+#include <span>
+#include <vector>
+
+namespace satisfactory {
+
+// A part of a problem which can be solved independently of the other parts.
+struct Block {
+  // Indices into the recipes of the input, in increasing order.
+  std::vector<int> recipes;
+  std::vector<Demand> demands;
+};
+
+// Splits a problem into blocks which share no recipes and no resources, so
+// that each limit applies within a single block. Resources which no recipe
+// changes the net quantity of, such as (ResourceNode), do not join blocks.
+//
+// Since the blocks are independent, the simplex algorithm pivots each one in
+// the same way whether it is solved on its own or as part of the tableau of
+// the whole problem, and breaks ties between optimal solutions the same way.
+// Blocks which shared the source recipes of raw resources would not: the
+// pivots of one block would change the price of the raw resource in another.
+//
+// Recipes which cannot contribute to meeting any of the demands are left out
+// of every block, as their uses are zero in an optimal solution.
+std::vector<Block> Decompose(const Input& input,
+                             std::span<const Demand> demands);
+
+}  // namespace satisfactory
+
+#endif  // DECOMPOSE_HPP_
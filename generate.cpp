@@ -0,0 +1,53 @@
+// Writes a randomly generated problem to stdout.
+//
+// Usage: solver_generate [--seed=<n>] [--resources=<n>] [--depth=<n>]
+//                        [--max-inputs=<n>] [--alternates=<x>]
+//                        [--byproducts=<p>] [--degeneracy=<p>]
+//                        [--demands=<n>] [--scenarios=<n>] [--limits=<p>]
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "generator.hpp"
+
+int main(int argc, char* argv[]) {
+  satisfactory::GeneratorOptions options;
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg = argv[i];
+    const std::string value(arg.substr(arg.find('=') + 1));
+    if (arg.starts_with("--seed=")) {
+      options.seed = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (arg.starts_with("--resources=")) {
+      options.resources = std::atoi(value.c_str());
+    } else if (arg.starts_with("--depth=")) {
+      options.depth = std::atoi(value.c_str());
+    } else if (arg.starts_with("--max-inputs=")) {
+      options.max_inputs = std::atoi(value.c_str());
+    } else if (arg.starts_with("--alternates=")) {
+      options.alternates = std::atof(value.c_str());
+    } else if (arg.starts_with("--byproducts=")) {
+      options.byproducts = std::atof(value.c_str());
+    } else if (arg.starts_with("--degeneracy=")) {
+      options.degeneracy = std::atof(value.c_str());
+    } else if (arg.starts_with("--demands=")) {
+      options.demands = std::atoi(value.c_str());
+    } else if (arg.starts_with("--scenarios=")) {
+      options.scenarios = std::atoi(value.c_str());
+    } else if (arg.starts_with("--limits=")) {
+      options.limits = std::atof(value.c_str());
+    } else {
+      std::cerr << "Usage: solver_generate [--seed=<n>] [--resources=<n>] "
+                   "[--depth=<n>]\n"
+                   "                       [--max-inputs=<n>] "
+                   "[--alternates=<x>]\n"
+                   "                       [--byproducts=<p>] "
+                   "[--degeneracy=<p>]\n"
+                   "                       [--demands=<n>] "
+                   "[--scenarios=<n>] [--limits=<p>]\n";
+      return 1;
+    }
+  }
+  std::cout << satisfactory::GenerateInput(options);
+}
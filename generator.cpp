@@ -0,0 +1,160 @@
+#include "generator.hpp"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <sstream>
+#include <vector>
+
+namespace satisfactory {
+namespace {
+
+class Generator {
+ public:
+  explicit Generator(const GeneratorOptions& options)
+      : options_(options), random_(options.seed) {
+    const int n = std::max(options_.resources, options_.depth + 1);
+    // tier_start_[t] is the index of the first resource in tier t.
+    for (int t = 0; t <= options_.depth + 1; t++) {
+      tier_start_.push_back(t * n / (options_.depth + 1));
+    }
+  }
+
+  std::string Generate() {
+    const int n = tier_start_.back();
+    output_ << "// Generated with seed " << options_.seed << ".\n\n";
+    if (options_.limits > 0) {
+      for (int i = 0; i < tier_start_[1]; i++) {
+        if (!Chance(options_.limits)) continue;
+        output_ << "limit ";
+        WriteResource(i);
+        output_ << " (" << Uniform(30, 300) << " units/min)\n";
+      }
+      output_ << '\n';
+    }
+    for (int i = 0; i < tier_start_[1]; i++) {
+      WriteRecipe(Recipe{.inputs = {},
+                         .outputs = {{i, Uniform(1, 2)}},
+                         .duration = 1,
+                         .cost = Uniform(1, 10)});
+    }
+    for (int i = tier_start_[1]; i < n; i++) {
+      const int alternates = int(options_.alternates) +
+                             Chance(options_.alternates -
+                                    int(options_.alternates));
+      for (int k = 0; k <= alternates; k++) {
+        const Recipe recipe = MakeRecipe(i);
+        WriteRecipe(recipe);
+        if (Chance(options_.degeneracy)) WriteRecipe(recipe);
+      }
+    }
+    if (options_.scenarios <= 0) {
+      output_ << '\n';
+      WriteDemands();
+    }
+    for (int s = 0; s < options_.scenarios; s++) {
+      output_ << "\n[Scenario " << s + 1 << "]\n";
+      WriteDemands();
+    }
+    return output_.str();
+  }
+
+ private:
+  struct Recipe {
+    // Pairs of resource index and quantity.
+    std::vector<std::pair<int, int>> inputs, outputs;
+    int duration;
+    int cost;
+    // The maximum use of the recipe, or zero if it is unlimited.
+    int limit = 0;
+  };
+
+  int Uniform(int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(random_);
+  }
+
+  bool Chance(double p) { return std::bernoulli_distribution(p)(random_); }
+
+  int Tier(int resource) const {
+    return std::ranges::upper_bound(tier_start_, resource) -
+           tier_start_.begin() - 1;
+  }
+
+  Recipe MakeRecipe(int resource) {
+    const bool unit = Chance(options_.degeneracy);
+    const auto quantity = [&] { return unit ? 1 : Uniform(1, 5); };
+    Recipe recipe{.inputs = {},
+                  .outputs = {{resource, quantity()}},
+                  .duration = unit ? 1 : Uniform(1, 10),
+                  .cost = unit ? 1 : Uniform(1, 10)};
+    // Inputs come from lower tiers, so that every resource can be produced
+    // from raw resources.
+    const int lower = tier_start_[Tier(resource)];
+    std::set<int> inputs;
+    const int k = Uniform(1, std::max(1, options_.max_inputs));
+    for (int j = 0; j < k; j++) inputs.insert(Uniform(0, lower - 1));
+    for (int input : inputs) recipe.inputs.push_back({input, quantity()});
+    if (Chance(options_.byproducts)) {
+      const int byproduct = Uniform(0, tier_start_.back() - 1);
+      if (byproduct != resource) {
+        recipe.outputs.push_back({byproduct, quantity()});
+      }
+    }
+    if (options_.limits > 0 && Chance(options_.limits)) {
+      recipe.limit = Uniform(1, 5);
+    }
+    return recipe;
+  }
+
+  void WriteResource(int resource) {
+    output_ << 'T' << Tier(resource) << 'R' << resource;
+  }
+
+  void WriteRecipe(const Recipe& recipe) {
+    const auto write_list = [&](const std::vector<std::pair<int, int>>& list) {
+      for (std::size_t i = 0; i < list.size(); i++) {
+        if (i > 0) output_ << " + ";
+        output_ << list[i].second << ' ';
+        WriteResource(list[i].first);
+      }
+    };
+    if (recipe.inputs.empty()) {
+      output_ << "(Node)";
+    } else {
+      write_list(recipe.inputs);
+    }
+    output_ << " -> ";
+    write_list(recipe.outputs);
+    output_ << " (" << recipe.duration << " s/run, cost " << recipe.cost;
+    if (recipe.limit > 0) output_ << ", max " << recipe.limit;
+    output_ << ")\n";
+  }
+
+  // Demands are drawn from the highest tier, which has the deepest production
+  // chains.
+  void WriteDemands() {
+    const int first = tier_start_[options_.depth];
+    const int last = tier_start_.back() - 1;
+    std::set<int> demanded;
+    for (int i = 0; i < options_.demands; i++) {
+      demanded.insert(Uniform(first, last));
+    }
+    for (int resource : demanded) {
+      WriteResource(resource);
+      output_ << " (" << Uniform(1, 60) << " units/min)\n";
+    }
+  }
+
+  const GeneratorOptions options_;
+  std::mt19937_64 random_;
+  std::vector<int> tier_start_;
+  std::ostringstream output_;
+};
+
+}  // namespace
+
+std::string GenerateInput(const GeneratorOptions& options) {
+  return Generator(options).Generate();
+}
+
+}  // namespace satisfactory
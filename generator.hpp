@@ -0,0 +1,46 @@
+#ifndef GENERATOR_HPP_
+#define GENERATOR_HPP_
+
+#include <cstdint>
+#include <string>
+
+namespace satisfactory {
+
+// Controls the shape of a generated problem.
+struct GeneratorOptions {
+  std::uint64_t seed = 1;
+  // The number of resources, which are split evenly into depth + 1 tiers. The
+  // resources in tier 0 are raw, and the recipes for each other tier consume
+  // resources from lower tiers.
+  int resources = 50;
+  int depth = 4;
+  // The most inputs that a recipe may have.
+  int max_inputs = 3;
+  // The average number of alternate recipes for each non-raw resource.
+  double alternates = 1;
+  // The probability that a recipe also produces a byproduct. The byproduct may
+  // be any resource, including one of the recipe's own inputs, so byproducts
+  // create cycles in the recipe graph.
+  double byproducts = 0.1;
+  // The probability that a recipe uses unit quantities, duration and cost, and
+  // separately that it is duplicated. Both create ties, which make the simplex
+  // algorithm perform degenerate pivots.
+  double degeneracy = 0;
+  // The number of resources demanded by each block of demands.
+  int demands = 3;
+  // If positive, this many named scenarios are generated instead of top-level
+  // demands.
+  int scenarios = 0;
+  // The probability that a recipe has a maximum use, and separately that the
+  // production of a raw resource is limited.
+  double limits = 0;
+};
+
+// Generates solver input. Unless limits are generated, the input always has a
+// feasible solution: every resource can be produced from raw resources without
+// using byproducts.
+std::string GenerateInput(const GeneratorOptions& options);
+
+}  // namespace satisfactory
+
+#endif  // GENERATOR_HPP_
@@ -0,0 +1,26 @@
+#ifndef HASH_HPP_
+#define HASH_HPP_
+
+#include <cstdint>
+#include <string_view>
+
+namespace satisfactory {
+
+inline constexpr std::uint64_t kFnvOffsetBasis = 0xcbf29ce484222325;
+
+// 64-bit FNV-1a. Passing the result of a previous call as the seed hashes the
+// concatenation of the inputs.
+constexpr std::uint64_t Fnv1a(std::string_view data,
+                              std::uint64_t seed = kFnvOffsetBasis) noexcept {
+  constexpr std::uint64_t kPrime = 0x100000001b3;
+  std::uint64_t hash = seed;
+  for (char c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= kPrime;
+  }
+  return hash;
+}
+
+}  // namespace satisfactory
+
+#endif  // HASH_HPP_
@@ -4,63 +4,320 @@
 #include <algorithm>
 #include <bit>
 #include <cassert>
+#include <charconv>
 #include <compare>
 #include <cstdint>
 #include <iostream>
+#include <numeric>
 #include <span>
+#include <string_view>
 
 namespace satisfactory {
 namespace integer {
 
-int RealSize(std::span<const std::uint32_t> value) noexcept;
+// The arithmetic kernels operate on little-endian spans of 32-bit words. They
+// are defined here rather than in a source file so that the integer types can
+// be used in constant expressions, such as when parsing at compile time.
+
+constexpr int RealSize(std::span<const std::uint32_t> value) noexcept {
+  for (int i = value.size() - 1; i >= 0; i--) {
+    if (value[i]) return i + 1;
+  }
+  return 0;
+}
+
+template <typename T>
+constexpr std::span<T> Narrow(std::span<T> value) noexcept {
+  return value.subspan(0, RealSize(value));
+}
 
 // destination += source
-void Add(std::span<std::uint32_t> destination, std::uint32_t source) noexcept;
-void Add(std::span<std::uint32_t> destination,
-         std::span<const std::uint32_t> source) noexcept;
+constexpr void Add(std::span<std::uint32_t> destination,
+                   std::uint32_t source) noexcept {
+  std::uint32_t carry = source;
+  const int n = destination.size();
+  for (int i = 0; i < n && carry; i++) {
+    std::uint64_t temp = std::uint64_t(destination[i]) + carry;
+    destination[i] = temp;
+    carry = temp >> 32;
+  }
+}
+
+constexpr void Add(std::span<std::uint32_t> destination,
+                   std::span<const std::uint32_t> source) noexcept {
+  const int n = std::min(destination.size(), source.size());
+  std::uint32_t carry = 0;
+  for (int i = 0; i < n; i++) {
+    std::uint64_t temp = std::uint64_t(destination[i]) + source[i] + carry;
+    destination[i] = temp;
+    carry = temp >> 32;
+  }
+  Add(destination.subspan(n), carry);
+}
 
 // destination -= source
-void Subtract(std::span<std::uint32_t> destination,
-              std::uint32_t source) noexcept;
-void Subtract(std::span<std::uint32_t> destination,
-              std::span<const std::uint32_t> source) noexcept;
+constexpr void Subtract(std::span<std::uint32_t> destination,
+                        std::uint32_t source) noexcept {
+  std::uint32_t carry = source;
+  const int n = destination.size();
+  for (int i = 0; i < n && carry; i++) {
+    std::uint64_t temp = std::uint64_t(destination[i]) - carry;
+    destination[i] = temp;
+    carry = bool(temp >> 32);
+  }
+}
+
+constexpr void Subtract(std::span<std::uint32_t> destination,
+                        std::span<const std::uint32_t> source) noexcept {
+  const int n = std::min(destination.size(), source.size());
+  std::uint32_t carry = 0;
+  for (int i = 0; i < n; i++) {
+    std::uint64_t temp = std::uint64_t(destination[i]) - source[i] - carry;
+    destination[i] = temp;
+    carry = bool(temp >> 32);
+  }
+  Subtract(destination.subspan(n), carry);
+}
+
+// destination -= source * factor
+// mod (1 << (32 * destination.size()))
+constexpr void SubtractMultiple(std::span<std::uint32_t> destination,
+                                std::span<const std::uint32_t> source,
+                                std::uint32_t factor) noexcept {
+  const int n = std::min(destination.size(), source.size() + 1);
+  // Since we are subtracting factor * (source << (32 * shift)), digits in the
+  // range destination.subspan(0, shift) cannot be affected.
+  const int source_size = source.size();
+  std::uint32_t mul_carry = 0, sub_carry = 0;
+  for (int i = 0; i < n; i++) {
+    // Calculate the ith digit of source * factor. The digit past the end of
+    // the source only holds the final carry.
+    const std::uint32_t digit = i < source_size ? source[i] : 0;
+    const std::uint64_t source_i = std::uint64_t(digit) * factor + mul_carry;
+    mul_carry = source_i >> 32;
+    // Calculate the ith digit of destination - source * factor
+    const std::uint64_t temp =
+        std::uint64_t(destination[i]) - std::uint32_t(source_i) - sub_carry;
+    destination[i] = temp;
+    sub_carry = bool(temp >> 32);
+  }
+  assert(std::uint64_t(mul_carry) + sub_carry < (std::uint64_t(1) << 32));
+  Subtract(destination.subspan(n), mul_carry + sub_carry);
+}
 
 // destination = a * b
-void Multiply(std::span<std::uint32_t> destination,
-              std::span<const std::uint32_t> a,
-              std::span<const std::uint32_t> b) noexcept;
+constexpr void Multiply(std::span<std::uint32_t> destination,
+                        std::span<const std::uint32_t> a,
+                        std::span<const std::uint32_t> b) noexcept {
+  std::ranges::fill(destination, 0);
+  a = Narrow(a);
+  b = Narrow(b);
+  const int n = destination.size();
+  const int a_size = a.size();
+  const int b_size = b.size();
+  for (int i = 0; i < a_size; i++) {
+    if (i >= n) break;
+    const int end = std::min(b_size - 1, n - i);
+    for (int j = 0; j <= end; j++) {
+      const std::uint64_t temp = std::uint64_t(a[i]) * std::uint64_t(b[j]);
+      const std::uint32_t words[] = {std::uint32_t(temp),
+                                     std::uint32_t(temp >> 32)};
+      Add(destination.subspan(i + j), words);
+    }
+  }
+}
 
 // Divide the destination by the source. Returns the remainder.
-std::uint32_t Divide(std::span<std::uint32_t> destination,
-                     std::uint32_t source) noexcept;
+constexpr std::uint32_t Divide(std::span<std::uint32_t> destination,
+                               std::uint32_t source) noexcept {
+  std::uint64_t carry = 0;
+  for (int i = destination.size() - 1; i >= 0; i--) {
+    const std::uint64_t x = carry << 32 | destination[i];
+    destination[i] = x / source;
+    carry = x % source;
+  }
+  return carry;
+}
+
+constexpr bool Equal(std::span<const std::uint32_t> a,
+                     std::span<const std::uint32_t> b) noexcept {
+  return std::ranges::equal(Narrow(a), Narrow(b));
+}
+
+constexpr std::strong_ordering Compare(
+    std::span<const std::uint32_t> a,
+    std::span<const std::uint32_t> b) noexcept {
+  a = Narrow(a);
+  b = Narrow(b);
+  if (auto result = a.size() <=> b.size(); result != 0) return result;
+  for (int i = a.size() - 1; i >= 0; i--) {
+    if (auto result = a[i] <=> b[i]; result != 0) return result;
+  }
+  return std::strong_ordering::equal;
+}
 
 // Sets destination equal to remainder / divisor and sets remainder equal to
 // remainder % divisor.
-void DivMod(std::span<std::uint32_t> quotient,
-            std::span<std::uint32_t> remainder,
-            std::span<const std::uint32_t> divisor) noexcept;
-
-void ShiftLeft(std::span<std::uint32_t> value, int amount) noexcept;
-void ShiftRight(std::span<std::uint32_t> value, int amount) noexcept;
+constexpr void DivMod(std::span<std::uint32_t> quotient,
+                      std::span<std::uint32_t> remainder,
+                      std::span<const std::uint32_t> divisor) noexcept {
+  remainder = Narrow(remainder);
+  divisor = Narrow(divisor);
+  std::fill(quotient.begin(), quotient.end(), 0);
+  assert(!divisor.empty());
+  while (true) {
+    // If the remainder is strictly smaller than the divisor, then the quotient
+    // is 0 and the remainder is simply the original number.
+    if (remainder.size() < divisor.size()) return;
+    int shift = int(remainder.size()) - int(divisor.size());
+
+    // If the divisor doesn't fit into the remainder at least once when aligning
+    // the leading digits, reduce the shift.
+    std::uint64_t remainder_prefix = remainder.back();
+    if (Compare(divisor, remainder.subspan(shift)) > 0) {
+      // If the shift is 0, the divisor doesn't fit into the remainder at all,
+      // so we are done.
+      if (shift == 0) return;
+      shift--;
+      remainder_prefix =
+          remainder_prefix << 32 | remainder[remainder.size() - 2];
+    }
 
-bool Equal(std::span<const std::uint32_t> a,
-           std::span<const std::uint32_t> b) noexcept;
-std::strong_ordering Compare(std::span<const std::uint32_t> a,
-                             std::span<const std::uint32_t> b) noexcept;
+    // Now we know that the divisor fits into the remainder at least once with
+    // the given alignment. Create an estimate for how many times it fits into
+    // the remainder.
+    assert(Compare(divisor, remainder.subspan(shift)) <= 0);
+    assert(divisor.back() + 1 > (remainder_prefix >> 32));
+    assert(divisor.back() <= remainder_prefix);
+
+    // Generate an underestimate for how many times the divisor fits into
+    // remainder.subspan(shift), by assuming the worst case (where the rest of
+    // the remainder is 0s after the prefix, and the rest of the divisor is 1s
+    // after the prefix).
+    const std::uint32_t estimate = remainder_prefix / (divisor.back() + 1);
+    if (estimate > 1) {
+      SubtractMultiple(remainder.subspan(shift), divisor, estimate);
+      Add(quotient.subspan(shift), estimate);
+    } else if (Compare(divisor, remainder.subspan(shift)) <= 0) {
+      Subtract(remainder.subspan(shift), divisor);
+      Add(quotient.subspan(shift), 1);
+    } else {
+      assert(estimate == 0);
+      assert(shift == 0);
+      break;
+    }
+    remainder = Narrow(remainder);
+  }
+}
+
+constexpr void ShiftLeft(std::span<std::uint32_t> value, int amount) noexcept {
+  const int major_shift = amount / 32;
+  const int minor_shift = amount % 32;
+  if (major_shift >= int(value.size())) {
+    std::ranges::fill(value, 0);
+    return;
+  }
+  if (minor_shift == 0) {
+    std::ranges::copy_backward(value.subspan(0, value.size() - major_shift),
+                               value.end());
+  } else {
+    for (int i = value.size() - 1; i > major_shift; i--) {
+      value[i] = value[i - major_shift] << minor_shift |
+                 value[i - major_shift - 1] >> (32 - minor_shift);
+    }
+    value[major_shift] = value[0] << minor_shift;
+  }
+  std::ranges::fill(value.subspan(0, major_shift), 0);
+}
+
+constexpr void ShiftRight(std::span<std::uint32_t> value, int amount) noexcept {
+  const int major_shift = amount / 32;
+  const int minor_shift = amount % 32;
+  if (major_shift >= int(value.size())) {
+    std::ranges::fill(value, 0);
+    return;
+  }
+  const int n = value.size() - major_shift - 1;
+  if (minor_shift == 0) {
+    std::ranges::copy(value.subspan(major_shift), value.begin());
+  } else {
+    for (int i = 0; i < n; i++) {
+      value[i] = value[i + major_shift] >> minor_shift |
+                 value[i + major_shift + 1] << (32 - minor_shift);
+    }
+    value[n] = value[n + major_shift] >> minor_shift;
+  }
+  std::ranges::fill(value.subspan(n + 1), 0);
+}
 
 // Parse a decimal value from a string_view. If the decimal value exceeds the
 // representable range of the destination, then it will be wrapped modularly.
 // scratch must be a buffer of at least the same size as destination, and will
 // be used as temporary storage space.
-void ParseDecimal(std::span<std::uint32_t> destination,
-                  std::span<std::uint32_t> scratch,
-                  std::string_view input) noexcept;
+constexpr void ParseDecimal(std::span<std::uint32_t> destination,
+                            std::span<std::uint32_t> scratch,
+                            std::string_view input) noexcept {
+  assert(scratch.size() >= destination.size());
+  scratch = scratch.subspan(0, destination.size());
+  constexpr int kBatchSize = 9;
+  constexpr std::uint32_t kBatchFactor = 1'000'000'000;  // 10^kBatchSize
+  assert(!destination.empty());
+  const int n = input.size();
+  const int first_batch_size = n % kBatchSize;
+  const int num_batches = 1 + n / kBatchSize;
+  // std::from_chars cannot be used in constant expressions.
+  const auto batch = [&](int first, int size) {
+    std::uint32_t value = 0;
+    for (char c : input.substr(first, size)) value = 10 * value + (c - '0');
+    return value;
+  };
+
+  // Each multiplication will toggle between using the destination buffer or the
+  // scratch buffer, so since we know exactly how many batches of digits there
+  // are, we can arrange that the final multiplication writes to the destination
+  // buffer.
+  std::span<std::uint32_t> a = destination;
+  std::span<std::uint32_t> b = scratch;
+  if (num_batches % 2 == 0) std::swap(a, b);
+
+  std::ranges::fill(a, 0);
+  a[0] = batch(0, first_batch_size);
+  for (int i = first_batch_size; i < n; i += kBatchSize) {
+    std::swap(a, b);
+    Multiply(a, b, std::span(&kBatchFactor, 1));
+    const std::uint32_t value = batch(i, kBatchSize);
+    Add(a, std::span(&value, 1));
+  }
+  assert(a.data() == destination.data());
+}
 
 // Encode the given integer as a decimal string stored in the given buffer,
 // returning the value. The buffer must be big enough to store the full
 // decimal value. Note: the source value is destructively modified.
-std::span<char> EncodeDecimal(std::span<char> buffer,
-                              std::span<std::uint32_t> value) noexcept;
+constexpr std::span<char> EncodeDecimal(
+    std::span<char> buffer, std::span<std::uint32_t> source) noexcept {
+  constexpr int kBatchSize = 9;
+  constexpr std::uint32_t kBatchFactor = 1'000'000'000;  // 10^kBatchSize
+  assert(!buffer.empty());
+  char* o = buffer.data() + buffer.size();
+  while (true) {
+    std::uint32_t remainder = Divide(source, kBatchFactor);
+    if (Equal(source, {})) {
+      // This is the last batch, which has no leading zeros.
+      do {
+        *--o = '0' + remainder % 10;
+        remainder /= 10;
+      } while (remainder);
+      return buffer.subspan(o - buffer.data());
+    }
+    // There are more significant non-zero digits, so the batch is padded with
+    // zeros.
+    for (int i = 0; i < kBatchSize; i++) {
+      *--o = '0' + remainder % 10;
+      remainder /= 10;
+    }
+  }
+}
 
 }  // namespace integer
 
@@ -90,7 +347,7 @@ class Uint {
 
   constexpr explicit operator double() const noexcept {
     double result = 0;
-    for (int i = kNumWords - 1; i >= 0; i++) {
+    for (int i = kNumWords - 1; i >= 0; i--) {
       result = result * (std::uint64_t(1) << 32) + value_[i];
     }
     return result;
@@ -107,6 +364,11 @@ class Uint {
   }
 
   constexpr Uint& operator*=(const Uint& u) noexcept {
+    // Most values are small enough for machine arithmetic, which is far
+    // cheaper, especially in constant expressions.
+    if (bit_width(*this) + bit_width(u) <= 64) {
+      return *this = Low64() * u.Low64();
+    }
     Uint temp = *this;
     integer::Multiply(value_, temp.value_, u.value_);
     return *this;
@@ -118,6 +380,9 @@ class Uint {
   }
 
   constexpr Uint& operator/=(const Uint& u) noexcept {
+    if (bit_width(*this) <= 64 && bit_width(u) <= 64) {
+      return *this = Low64() / u.Low64();
+    }
     Uint copy = *this;
     integer::DivMod(value_, copy.value_, u.value_);
     return *this;
@@ -131,6 +396,9 @@ class Uint {
   }
 
   constexpr Uint& operator%=(const Uint& u) noexcept {
+    if (bit_width(*this) <= 64 && bit_width(u) <= 64) {
+      return *this = Low64() % u.Low64();
+    }
     integer::DivMod(std::span<std::uint32_t>(), value_, u.value_);
     return *this;
   }
@@ -158,6 +426,7 @@ class Uint {
   }
 
   friend constexpr Uint operator*(const Uint& l, const Uint& r) noexcept {
+    if (bit_width(l) + bit_width(r) <= 64) return l.Low64() * r.Low64();
     Uint temp;
     integer::Multiply(temp.value_, l.value_, r.value_);
     return temp;
@@ -215,7 +484,19 @@ class Uint {
     return 32 * major + minor;
   }
 
+  // The number of bits needed to represent the value, which is 0 for 0.
+  friend constexpr int bit_width(const Uint<n>& u) {
+    int major = kNumWords;
+    while (major > 0 && u.value_[major - 1] == 0) major--;
+    if (major == 0) return 0;
+    return 32 * (major - 1) + std::bit_width(u.value_[major - 1]);
+  }
+
   friend constexpr Uint gcd(Uint l, Uint r) {
+    // Most values fit in a machine word, whose gcd is far cheaper.
+    if (bit_width(l) <= 64 && bit_width(r) <= 64) {
+      return std::gcd(l.Low64(), r.Low64());
+    }
     if (l == 0) return r;
     if (r == 0) return l;
     const int i = countr_zero(l);
@@ -231,6 +512,24 @@ class Uint {
     }
   }
 
+  // The little-endian 32-bit words of the value.
+  constexpr std::span<const std::uint32_t> words() const noexcept {
+    return value_;
+  }
+  constexpr std::span<std::uint32_t> words() noexcept { return value_; }
+
+  // Writes the decimal representation of x, following the conventions of
+  // std::to_chars.
+  friend constexpr std::to_chars_result to_chars(char* first, char* last,
+                                                 Uint x) noexcept {
+    char temp[kNumWords * 10];
+    const std::span<char> digits = integer::EncodeDecimal(temp, x.value_);
+    if (last - first < std::ssize(digits)) {
+      return {last, std::errc::value_too_large};
+    }
+    return {std::copy(digits.begin(), digits.end(), first), std::errc()};
+  }
+
   friend constexpr std::ostream& operator<<(std::ostream& output,
                                             Uint x) noexcept {
     char temp[kNumWords * 10];
@@ -242,6 +541,15 @@ class Uint {
  private:
   static constexpr int kNumWords = (n + 31) / 32;
 
+  // The value modulo 2^64.
+  constexpr std::uint64_t Low64() const noexcept {
+    if constexpr (kNumWords == 1) {
+      return value_[0];
+    } else {
+      return std::uint64_t(value_[1]) << 32 | value_[0];
+    }
+  }
+
   std::uint32_t value_[kNumWords] = {};
 };
 
@@ -375,6 +683,21 @@ class Int {
     return gcd(l.value_, r.value_);
   }
 
+  constexpr bool negative() const noexcept { return negative_; }
+  constexpr const Uint<n>& magnitude() const noexcept { return value_; }
+
+  // The number of bits needed to represent the magnitude of the value.
+  friend constexpr int bit_width(const Int& x) { return bit_width(x.value_); }
+
+  friend constexpr std::to_chars_result to_chars(char* first, char* last,
+                                                 const Int& x) noexcept {
+    if (x.negative_ && x.value_ != 0) {
+      if (first == last) return {last, std::errc::value_too_large};
+      *first++ = '-';
+    }
+    return to_chars(first, last, x.value_);
+  }
+
   friend constexpr std::ostream& operator<<(std::ostream& output,
                                             const Int& x) noexcept {
     if (x.negative_) output << '-';
@@ -1,5 +1,8 @@
 #include "integer.hpp"
 
+#include <sstream>
+#include <string_view>
+
 #define CHECK_EQ(a, b) ::DoCheckPred<std::equal_to<>{}>(#a, "==", #b, (a), (b))
 #define CHECK_LT(a, b) ::DoCheckPred<std::less<>{}>(#a, "<", #b, (a), (b))
 #define CHECK_LE(a, b) \
@@ -27,6 +30,17 @@ void DoCheckPred(const char* l_string, const char* op, const char* r_string,
 using ::satisfactory::uint128;
 using ::satisfactory::int128;
 
+// The arithmetic is usable in constant expressions.
+static_assert(uint128("999999999999000001999999") / uint128("999999000001") ==
+              uint128("1000000999999"));
+static_assert(gcd(int128(-84), int128(36)) == 12);
+static_assert([] {
+  char buffer[40] = {};
+  const auto [end, error] = to_chars(buffer, buffer + 40,
+                                     uint128("1000000000000000000007"));
+  return std::string_view(buffer, end) == "1000000000000000000007";
+}());
+
 int main() {
   // Check that small integers are represented correctly.
   CHECK_EQ(uint128(0x8000'0000ULL), 0x8000'0000ULL);
@@ -56,4 +70,16 @@ int main() {
   CHECK_EQ(uint128("999999999999000001999998") % uint128("999999000001"),
            uint128("999999000000"));
   CHECK_EQ(uint128("999999999999000002000000") % uint128("999999000001"), 1);
+
+  // Check that bit widths span word boundaries.
+  CHECK_EQ(bit_width(uint128(0)), 0);
+  CHECK_EQ(bit_width(uint128(0xFFFF'FFFF)), 32);
+  CHECK_EQ(bit_width(uint128(0x1'0000'0000)), 33);
+  CHECK_EQ(bit_width(int128(-5)), 3);
+
+  // Check that decimals are encoded with the zeros inside and between batches.
+  std::ostringstream decimal;
+  decimal << uint128("1000000000000000000") << ' ' << int128(-0) << ' '
+          << int128("-1234567890123");
+  CHECK_EQ(decimal.str(), "1000000000000000000 0 -1234567890123");
 }
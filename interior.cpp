@@ -0,0 +1,344 @@
+#include "interior.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <utility>
+
+#include "thread_pool.hpp"
+#include "trace.hpp"
+
+namespace satisfactory {
+namespace {
+
+// The relative accuracy at which the solution is considered optimal.
+constexpr double kTolerance = 1e-8;
+
+// The most iterations before giving up. Problems which can be solved usually
+// take a few dozen, whatever their size.
+constexpr int kMaxIterations = 100;
+
+// Values beyond this mean that the iterates are diverging, as they do when the
+// demands cannot be met.
+constexpr double kDivergence = 1e15;
+
+// The fraction of the way to the boundary that each step goes, which keeps the
+// iterates strictly inside it.
+constexpr double kStepFraction = 0.99;
+
+// The Cholesky factorization works on blocks of this many columns, with the
+// rows below each block computed in parallel.
+constexpr int kBlockSize = 64;
+
+using Vector = std::vector<double>;
+
+double Dot(std::span<const double> a, std::span<const double> b) {
+  double result = 0;
+  for (std::size_t i = 0; i < a.size(); i++) result += a[i] * b[i];
+  return result;
+}
+
+double MaxAbs(std::span<const double> a) {
+  double result = 0;
+  for (double x : a) result = std::max(result, std::abs(x));
+  return result;
+}
+
+// The largest step that keeps x + step * dx non-negative.
+double MaxStep(std::span<const double> x, std::span<const double> dx) {
+  double step = std::numeric_limits<double>::infinity();
+  for (std::size_t i = 0; i < x.size(); i++) {
+    if (dx[i] < 0) step = std::min(step, -x[i] / dx[i]);
+  }
+  return step;
+}
+
+// The problem in standard form: minimize dot(c, v) subject to G v = b and
+// v >= 0, where v is the recipe uses followed by the surpluses of the
+// resources, and G = [A -I] for the net rates A of the recipes. A is sparse,
+// as each recipe only involves a few resources, and is stored both by recipe
+// and by resource.
+class Problem {
+ public:
+  Problem(const Input& input, std::span<const Demand> demands,
+          std::span<const std::string_view> resources)
+      : n_(resources.size()),
+        r_(input.recipes.size()),
+        columns_(r_),
+        rows_(n_),
+        c_(r_ + n_),
+        b_(n_) {
+    const auto index = [&](std::string_view name) -> int {
+      return std::ranges::lower_bound(resources, name) - resources.begin();
+    };
+    for (int i = 0; i < r_; i++) {
+      const Recipe& recipe = input.recipes[i];
+      // Only net quantities matter, as in the tableau.
+      std::map<int, Rational> quantities;
+      for (const auto& [resource, quantity] : recipe.inputs) {
+        quantities[index(resource)] -= quantity;
+      }
+      for (const auto& [resource, quantity] : recipe.outputs) {
+        quantities[index(resource)] += quantity;
+      }
+      for (const auto& [j, quantity] : quantities) {
+        if (quantity == 0) continue;
+        const double rate = static_cast<double>(quantity / recipe.duration);
+        columns_[i].push_back({j, rate});
+        rows_[j].push_back({i, rate});
+      }
+      c_[i] = static_cast<double>(recipe.cost);
+    }
+    for (const auto& [resource, rate] : demands) {
+      b_[index(resource)] += static_cast<double>(rate / 60);
+    }
+  }
+
+  int n() const { return n_; }
+  int r() const { return r_; }
+  int size() const { return r_ + n_; }
+  std::span<const double> c() const { return c_; }
+  std::span<const double> b() const { return b_; }
+
+  // Returns G v.
+  Vector Multiply(std::span<const double> v) const {
+    Vector result(n_);
+    for (int i = 0; i < r_; i++) {
+      if (v[i] == 0) continue;
+      for (const auto& [j, rate] : columns_[i]) result[j] += rate * v[i];
+    }
+    for (int j = 0; j < n_; j++) result[j] -= v[r_ + j];
+    return result;
+  }
+
+  // Returns G^T y.
+  Vector MultiplyTransposed(std::span<const double> y) const {
+    Vector result(r_ + n_);
+    for (int i = 0; i < r_; i++) {
+      for (const auto& [j, rate] : columns_[i]) result[i] += rate * y[j];
+    }
+    for (int j = 0; j < n_; j++) result[r_ + j] = -y[j];
+    return result;
+  }
+
+  // Returns the lower triangle of the normal matrix G D G^T, for the diagonal
+  // matrix D given by d, as a dense n x n matrix in row-major order. Each row
+  // sums over the recipes which involve its resource, so the rows can be
+  // computed in parallel.
+  Vector NormalMatrix(std::span<const double> d, int num_threads) const {
+    Vector m(static_cast<std::size_t>(n_) * n_);
+    ParallelFor(
+        n_,
+        [&](int j) {
+          double* row = &m[static_cast<std::size_t>(j) * n_];
+          for (const auto& [i, a] : rows_[j]) {
+            const double scale = a * d[i];
+            for (const auto& [k, rate] : columns_[i]) {
+              if (k <= j) row[k] += scale * rate;
+            }
+          }
+          row[j] += d[r_ + j];
+        },
+        num_threads);
+    return m;
+  }
+
+ private:
+  int n_, r_;
+  std::vector<std::vector<std::pair<int, double>>> columns_, rows_;
+  Vector c_, b_;
+};
+
+// Replaces the lower triangle of a symmetric positive definite matrix with its
+// Cholesky factor L, so that the matrix is L L^T. Each entry of L is a dot
+// product of two rows of L to its left, so once a block of columns is done for
+// the rows which it spans, the rest of the block can be filled in for each row
+// below independently. Near the optimum the matrix becomes very badly
+// conditioned, and a pivot may vanish or turn negative through rounding, in
+// which case it is replaced by a huge value so that the corresponding
+// component of the solution is zero.
+void Factorize(Vector& m, int n, int num_threads) {
+  const auto row = [&](int i) {
+    return std::span<double>(&m[static_cast<std::size_t>(i) * n], n);
+  };
+  Vector diagonal(n);
+  for (int i = 0; i < n; i++) diagonal[i] = row(i)[i];
+  const auto entry = [&](int i, int k) {
+    const std::span<double> a = row(i), b = row(k);
+    const double x = a[k] - Dot(a.first(k), b.first(k));
+    if (i != k) {
+      a[k] = x / b[k];
+    } else {
+      a[k] = x > 1e-30 * std::max(diagonal[k], 1.0) ? std::sqrt(x) : 1e64;
+    }
+  };
+  for (int k0 = 0; k0 < n; k0 += kBlockSize) {
+    const int k1 = std::min(n, k0 + kBlockSize);
+    for (int i = k0; i < k1; i++) {
+      for (int k = k0; k <= i; k++) entry(i, k);
+    }
+    ParallelFor(
+        n - k1,
+        [&](int i) {
+          for (int k = k0; k < k1; k++) entry(k1 + i, k);
+        },
+        num_threads);
+  }
+}
+
+// Solves L L^T x = b for the factor L from Factorize.
+Vector Substitute(const Vector& l, int n, Vector b) {
+  const auto at = [&](int i, int k) {
+    return l[static_cast<std::size_t>(i) * n + k];
+  };
+  for (int i = 0; i < n; i++) {
+    for (int k = 0; k < i; k++) b[i] -= at(i, k) * b[k];
+    b[i] /= at(i, i);
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    b[i] /= at(i, i);
+    for (int k = 0; k < i; k++) b[k] -= at(i, k) * b[i];
+  }
+  return b;
+}
+
+// A step of the iterates.
+struct Direction {
+  Vector v, y, z;
+};
+
+}  // namespace
+
+std::optional<InteriorSolution> SolveInterior(
+    const Input& input, std::span<const Demand> demands,
+    std::span<const std::string_view> resources, int num_threads,
+    const std::function<bool()>& stop) {
+  const TraceSpan span("SolveInterior");
+  const Problem problem(input, demands, resources);
+  const int n = problem.n();
+  const int size = problem.size();
+  const std::span<const double> b = problem.b(), c = problem.c();
+  if (size == 0) {
+    return InteriorSolution{.uses = {},
+                            .reduced_costs = {},
+                            .prices = {},
+                            .surpluses = {},
+                            .iterations = 0};
+  }
+  // Given the factorized normal matrix for D = diag(d), solves the Newton
+  // equations
+  //
+  //   G dv = rp,  G^T dy + dz = rd,  Z dv + V dz = rc
+  //
+  // where V = diag(v) and Z = diag(z), by eliminating dz and then dv.
+  const auto newton = [&](const Vector& l, const Vector& v, const Vector& z,
+                          const Vector& d, const Vector& rp, const Vector& rd,
+                          const Vector& rc) {
+    Vector t(size);
+    for (int i = 0; i < size; i++) t[i] = (rc[i] - v[i] * rd[i]) / z[i];
+    Vector rhs = problem.Multiply(t);
+    for (int j = 0; j < n; j++) rhs[j] = rp[j] - rhs[j];
+    Direction direction;
+    direction.y = Substitute(l, n, std::move(rhs));
+    const Vector gy = problem.MultiplyTransposed(direction.y);
+    direction.v.resize(size);
+    direction.z.resize(size);
+    for (int i = 0; i < size; i++) {
+      direction.z[i] = rd[i] - gy[i];
+      direction.v[i] = t[i] + d[i] * gy[i];
+    }
+    return direction;
+  };
+  // Mehrotra's starting point: the least-squares solutions of G v = b and
+  // G^T y + z = c, shifted to be positive and roughly centered.
+  Vector v, y, z;
+  {
+    const Vector ones(size, 1.0);
+    Vector l = problem.NormalMatrix(ones, num_threads);
+    Factorize(l, n, num_threads);
+    v = problem.MultiplyTransposed(Substitute(l, n, {b.begin(), b.end()}));
+    y = Substitute(l, n, problem.Multiply(c));
+    const Vector gy = problem.MultiplyTransposed(y);
+    z.resize(size);
+    for (int i = 0; i < size; i++) z[i] = c[i] - gy[i];
+    const auto shift = [](Vector& x) {
+      const double low = *std::ranges::min_element(x);
+      const double delta = std::max(-1.5 * low, 0.0);
+      for (double& e : x) e += delta;
+    };
+    shift(v);
+    shift(z);
+    const double product = std::max(Dot(v, z), 1e-3);
+    double sum_v = 0, sum_z = 0;
+    for (int i = 0; i < size; i++) {
+      sum_v += v[i];
+      sum_z += z[i];
+    }
+    const double delta_v = 0.5 * product / std::max(sum_z, 1e-3);
+    const double delta_z = 0.5 * product / std::max(sum_v, 1e-3);
+    for (int i = 0; i < size; i++) {
+      v[i] += delta_v;
+      z[i] += delta_z;
+    }
+  }
+  const double b_norm = 1 + MaxAbs(b), c_norm = 1 + MaxAbs(c);
+  for (int iteration = 0; iteration < kMaxIterations; iteration++) {
+    const TraceSpan span("InteriorIteration");
+    Vector rp = problem.Multiply(v);
+    for (int j = 0; j < n; j++) rp[j] = b[j] - rp[j];
+    Vector rd = problem.MultiplyTransposed(y);
+    for (int i = 0; i < size; i++) rd[i] = c[i] - rd[i] - z[i];
+    const double primal = Dot(c, v), dual = Dot(b, y);
+    if (MaxAbs(rp) <= kTolerance * b_norm &&
+        MaxAbs(rd) <= kTolerance * c_norm &&
+        std::abs(primal - dual) <= kTolerance * (1 + std::abs(primal))) {
+      const int r = problem.r();
+      return InteriorSolution{
+          .uses = Vector(v.begin(), v.begin() + r),
+          .reduced_costs = Vector(z.begin(), z.begin() + r),
+          .prices = std::move(y),
+          .surpluses = Vector(v.begin() + r, v.end()),
+          .iterations = iteration};
+    }
+    if (stop && stop()) return std::nullopt;
+    if (MaxAbs(v) > kDivergence || MaxAbs(y) > kDivergence) {
+      return std::nullopt;
+    }
+    Vector d(size);
+    for (int i = 0; i < size; i++) d[i] = v[i] / z[i];
+    Vector l = problem.NormalMatrix(d, num_threads);
+    Factorize(l, n, num_threads);
+    const double mu = Dot(v, z) / size;
+    // The predictor aims straight for the optimum, and shows how far the
+    // iterates can go before hitting the boundary.
+    Vector rc(size);
+    for (int i = 0; i < size; i++) rc[i] = -v[i] * z[i];
+    const Direction affine = newton(l, v, z, d, rp, rd, rc);
+    const double primal_step = std::min(1.0, MaxStep(v, affine.v));
+    const double dual_step = std::min(1.0, MaxStep(z, affine.z));
+    double mu_affine = 0;
+    for (int i = 0; i < size; i++) {
+      mu_affine += (v[i] + primal_step * affine.v[i]) *
+                   (z[i] + dual_step * affine.z[i]);
+    }
+    mu_affine /= size;
+    // The corrector re-centers the iterates in proportion to how far the
+    // predictor fell short, and corrects for its second-order error.
+    const double sigma = std::pow(mu_affine / mu, 3);
+    for (int i = 0; i < size; i++) {
+      rc[i] -= affine.v[i] * affine.z[i] - sigma * mu;
+    }
+    const Direction direction = newton(l, v, z, d, rp, rd, rc);
+    const double alpha = std::min(1.0, kStepFraction * MaxStep(v, direction.v));
+    const double beta = std::min(1.0, kStepFraction * MaxStep(z, direction.z));
+    for (int i = 0; i < size; i++) {
+      v[i] += alpha * direction.v[i];
+      z[i] += beta * direction.z[i];
+    }
+    for (int j = 0; j < n; j++) y[j] += beta * direction.y[j];
+  }
+  return std::nullopt;
+}
+
+}  // namespace satisfactory
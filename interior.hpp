@@ -0,0 +1,49 @@
+#ifndef INTERIOR_HPP_
+#define INTERIOR_HPP_
+
+#include "data.hpp"
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace satisfactory {
+
+// An approximately optimal solution to a problem, in floating point. Rates are
+// per second, as in the tableau.
+struct InteriorSolution {
+  // The use of each recipe, and its reduced cost at the prices.
+  std::vector<double> uses, reduced_costs;
+  // The price of each resource, and how much more of it is produced than is
+  // demanded, in the order of the resources that were given.
+  std::vector<double> prices, surpluses;
+  int iterations;
+};
+
+// Solves a problem without bounds by the primal-dual interior-point method,
+// with Mehrotra's predictor-corrector steps. Rather than moving from vertex to
+// vertex like the simplex algorithm, each iteration moves through the interior
+// of the feasible region towards the optimum, and the number of iterations
+// barely grows with the size of the problem. Each one solves the normal
+// equations, whose matrix has a row per resource however many recipes there
+// are, by a Cholesky factorization on up to num_threads threads.
+//
+// At the optimum, each recipe either has a use or a reduced cost, and each
+// resource either has a price or a surplus, which identifies the optimal basis
+// unless several solutions are optimal. The values are only accurate to about
+// eight significant digits, so the basis must be confirmed in exact
+// arithmetic.
+//
+// The resources must be sorted, as returned by Resources. Returns std::nullopt
+// if the method does not converge, as when the demands cannot be met, or if
+// stop returns true between two iterations.
+std::optional<InteriorSolution> SolveInterior(
+    const Input& input, std::span<const Demand> demands,
+    std::span<const std::string_view> resources, int num_threads = 1,
+    const std::function<bool()>& stop = nullptr);
+
+}  // namespace satisfactory
+
+#endif  // INTERIOR_HPP_
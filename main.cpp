@@ -1,35 +1,514 @@
-#include <fstream>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include "base_game.hpp"
+#include "basis.hpp"
+#include "batch.hpp"
+#include "cache.hpp"
+#include "certificate.hpp"
+#include "module.hpp"
+#include "output.hpp"
 #include "parser.hpp"
+#include "server.hpp"
 #include "solver.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
 
 namespace {
 
-std::string GetContents(const char* filename) {
-  std::ifstream file(filename);
-  const std::string source(std::istreambuf_iterator<char>(file), {});
-  if (!file.good()) {
-    std::cerr << "Failed to read " << filename << "\n";
-    std::exit(1);
+struct Options {
+  const char* filename = nullptr;
+  // Solve the built-in base game database rather than a file.
+  bool base_game = false;
+  std::filesystem::path module_cache;
+  // Server mode: serve requests from stdin, or from a Unix socket if a path
+  // is given.
+  bool serve = false;
+  std::string socket;
+  // Client mode: forward stdin to the server at this socket.
+  std::string connect;
+  int threads = 0;
+  // Solution cache: the number of solutions kept in memory, and a directory
+  // in which solutions are persisted.
+  std::size_t cache_size = 0;
+  std::filesystem::path solution_cache;
+  bool cache_stats = false;
+  // Warm starts: reuse and update the optimal bases stored in this file.
+  std::filesystem::path basis_file;
+  satisfactory::Format format = satisfactory::Format::kText;
+  satisfactory::Numbers numbers = satisfactory::Numbers::kExact;
+  // Report timings and other measurements of each solve.
+  bool stats = false;
+  // Write a Chrome trace of the run to this file.
+  std::filesystem::path trace_file;
+  // Solve by column generation rather than with every recipe at once.
+  bool column_generation = false;
+  // How to find the optimal basis of each block.
+  satisfactory::Engine engine = satisfactory::Engine::kAuto;
+  // Only use recipes in whole multiples of this, such as whole machines.
+  std::optional<satisfactory::Rational> granularity;
+  // Stop searching for whole multiples after this many nodes, if positive.
+  std::int64_t max_nodes = 0;
+  // Minimize these in turn rather than the cost, if non-empty.
+  std::vector<satisfactory::Objective> objectives;
+  // Report marginal costs, reduced costs and ranges with each solution.
+  bool sensitivity = false;
+  // Check that each solution is optimal, independently of the solver.
+  bool certify = false;
+  // Stop solving after this long, if set.
+  std::optional<std::chrono::duration<double>> time_limit;
+  // Sweep the top-level demands, scaled by t, over this range of t.
+  std::optional<std::pair<satisfactory::Rational, satisfactory::Rational>>
+      sweep;
+};
+
+[[noreturn]] void Usage() {
+  std::cerr << "Usage: solver [options] [--threads=<n>] <filename>\n"
+               "       solver [options] [--threads=<n>] --base-game\n"
+               "       solver [options] [--threads=<n>] --serve[=<socket>]\n"
+               "       solver --connect=<socket>\n"
+               "Options:\n"
+               "  --base-game             Solve the base game database built\n"
+               "                          into the solver (building.txt).\n"
+               "  --module-cache=<dir>    Persist parsed input files.\n"
+               "  --cache-size=<n>        Keep up to n solutions in memory.\n"
+               "  --solution-cache=<dir>  Persist solutions.\n"
+               "  --cache-stats           Report solution cache statistics.\n"
+               "  --basis[=<file>]        Warm start from the bases saved in\n"
+               "                          <filename>.basis, and update them.\n"
+               "  --format=<format>       Print text (default), jsonl or csv.\n"
+               "  --decimal               Output decimals instead of\n"
+               "                          fractions in jsonl and csv.\n"
+               "  --stats                 Report statistics for each solve.\n"
+               "  --trace=<file>          Write a Chrome trace of the run.\n"
+               "  --column-generation     Only add recipes to the tableau\n"
+               "                          once they would reduce the cost.\n"
+               "  --engine=<engine>       Find optimal bases with auto\n"
+               "                          (default), simplex or\n"
+               "                          interior-point.\n"
+               "  --integer[=<step>]      Use each recipe in whole multiples\n"
+               "                          of step (default 1), such as whole\n"
+               "                          machines. This can be slow.\n"
+               "  --max-nodes=<n>         With --integer, settle for the best\n"
+               "                          solution found after n nodes.\n"
+               "  --objectives=<list>     Minimize each of a comma-separated\n"
+               "                          list in turn instead of the cost:\n"
+               "                          cost, machines, raw (resources\n"
+               "                          extracted) or a resource produced.\n"
+               "  --sensitivity           Report the marginal cost of each\n"
+               "                          resource, the reduced cost of each\n"
+               "                          recipe, and the ranges of demands\n"
+               "                          and costs which keep them.\n"
+               "  --certify               Check that each solution is optimal\n"
+               "                          with a certificate from the solver.\n"
+               "  --time-limit=<s>        Stop solving after s seconds,\n"
+               "                          giving the best whole solution\n"
+               "                          found so far with --integer, or\n"
+               "                          none otherwise.\n"
+               "  --sweep=<from>:<to>     Solve for the demands scaled by\n"
+               "                          every t from <from> to <to>,\n"
+               "                          printing the solutions where the\n"
+               "                          uses change.\n";
+  std::exit(1);
+}
+
+// Parses a comma-separated list of objectives, such as "raw,machines".
+std::vector<satisfactory::Objective> ParseObjectives(std::string_view list) {
+  using Kind = satisfactory::Objective::Kind;
+  std::vector<satisfactory::Objective> objectives;
+  while (true) {
+    const std::size_t comma = list.find(',');
+    const std::string_view name = list.substr(0, comma);
+    if (name.empty()) Usage();
+    satisfactory::Objective& objective = objectives.emplace_back();
+    if (name == "cost") {
+      objective.kind = Kind::kCost;
+    } else if (name == "machines") {
+      objective.kind = Kind::kMachines;
+    } else if (name == "raw") {
+      objective.kind = Kind::kRawResources;
+    } else {
+      objective.kind = Kind::kProduction;
+      objective.resource = name;
+    }
+    if (comma == list.npos) return objectives;
+    list.remove_prefix(comma + 1);
+  }
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg = argv[i];
+    const std::string_view value = arg.substr(arg.find('=') + 1);
+    if (arg == "--base-game") {
+      options.base_game = true;
+    } else if (arg.starts_with("--module-cache=")) {
+      options.module_cache = value;
+    } else if (arg == "--serve") {
+      options.serve = true;
+    } else if (arg.starts_with("--serve=")) {
+      options.serve = true;
+      options.socket = value;
+    } else if (arg.starts_with("--connect=")) {
+      options.connect = value;
+    } else if (arg.starts_with("--cache-size=")) {
+      options.cache_size = std::atoll(std::string(value).c_str());
+    } else if (arg.starts_with("--solution-cache=")) {
+      options.solution_cache = value;
+    } else if (arg == "--cache-stats") {
+      options.cache_stats = true;
+    } else if (arg == "--basis") {
+      options.basis_file = "-";
+    } else if (arg.starts_with("--basis=")) {
+      options.basis_file = value;
+    } else if (arg == "--format=text") {
+      options.format = satisfactory::Format::kText;
+    } else if (arg == "--format=jsonl") {
+      options.format = satisfactory::Format::kJsonLines;
+    } else if (arg == "--format=csv") {
+      options.format = satisfactory::Format::kCsv;
+    } else if (arg == "--decimal") {
+      options.numbers = satisfactory::Numbers::kDecimal;
+    } else if (arg == "--stats") {
+      options.stats = true;
+    } else if (arg.starts_with("--trace=")) {
+      options.trace_file = value;
+    } else if (arg == "--column-generation") {
+      options.column_generation = true;
+    } else if (arg == "--engine=auto") {
+      options.engine = satisfactory::Engine::kAuto;
+    } else if (arg == "--engine=simplex") {
+      options.engine = satisfactory::Engine::kSimplex;
+    } else if (arg == "--engine=interior-point") {
+      options.engine = satisfactory::Engine::kInteriorPoint;
+    } else if (arg == "--integer") {
+      options.granularity = 1;
+    } else if (arg.starts_with("--integer=")) {
+      options.granularity = satisfactory::ParseRational(value);
+      if (!options.granularity || *options.granularity <= 0) Usage();
+    } else if (arg.starts_with("--max-nodes=")) {
+      options.max_nodes = std::atoll(std::string(value).c_str());
+    } else if (arg.starts_with("--objectives=")) {
+      options.objectives = ParseObjectives(value);
+    } else if (arg == "--sensitivity") {
+      options.sensitivity = true;
+    } else if (arg == "--certify") {
+      options.certify = true;
+    } else if (arg.starts_with("--time-limit=")) {
+      options.time_limit = std::chrono::duration<double>(
+          std::atof(std::string(value).c_str()));
+    } else if (arg.starts_with("--sweep=")) {
+      const std::size_t colon = value.find(':');
+      if (colon == value.npos) Usage();
+      const std::optional<satisfactory::Rational> from =
+          satisfactory::ParseRational(value.substr(0, colon));
+      const std::optional<satisfactory::Rational> to =
+          satisfactory::ParseRational(value.substr(colon + 1));
+      if (!from || !to || *from > *to) Usage();
+      options.sweep.emplace(*from, *to);
+    } else if (arg.starts_with("--threads=")) {
+      options.threads = std::atoi(std::string(value).c_str());
+    } else if (arg.starts_with("-") || options.filename) {
+      Usage();
+    } else {
+      options.filename = argv[i];
+    }
+  }
+  if (!options.solution_cache.empty() && options.cache_size == 0) {
+    options.cache_size = 1024;
+  }
+  const bool server_or_client = options.serve || !options.connect.empty();
+  const bool input = options.filename || options.base_game;
+  if (options.filename && options.base_game) Usage();
+  if (server_or_client == input) Usage();
+  if (options.stats && !input) Usage();
+  if (options.basis_file == "-") {
+    if (!options.filename) Usage();
+    options.basis_file = std::string(options.filename) + ".basis";
+  }
+  return options;
+}
+
+// Formats the result for a scenario. Scenarios are named, while the top-level
+// demands of an input file are not.
+std::string Format(const Options& options,
+                   std::optional<std::string_view> name,
+                   const std::optional<satisfactory::Solution>& solution,
+                   bool stopped = false) {
+  using satisfactory::Format;
+  if (stopped) {
+    if (name) std::cerr << *name << ": ";
+    std::cerr << (solution ? "The time limit was reached, so this solution "
+                             "may not be optimal.\n"
+                           : "The time limit was reached before a solution "
+                             "was found.\n");
+  } else if (!solution) {
+    if (name) std::cerr << *name << ": ";
+    std::cerr << "A solution could not be found. Is a recipe missing, or is a "
+                 "limit too low?\n";
+  }
+  if (options.format == Format::kText) {
+    if (!solution) return "";
+    std::ostringstream output;
+    if (name) output << "=== " << *name << " ===\n\n";
+    output << *solution << (name ? "\n\n" : "\n");
+    return output.str();
+  }
+  // The buffer is reused across scenarios solved on the same thread.
+  thread_local satisfactory::OutputBuffer output;
+  output.Clear();
+  const std::string_view scenario = name.value_or("");
+  if (options.format == Format::kJsonLines) {
+    const satisfactory::Tag tag = {"scenario", scenario};
+    const std::span<const satisfactory::Tag> tags(&tag, name ? 1 : 0);
+    if (solution) {
+      satisfactory::WriteJsonLine(output, *solution, tags, options.numbers);
+    } else {
+      output.Append('{');
+      for (const auto& [key, value] : tags) {
+        output.AppendJsonString(key);
+        output.Append(':');
+        output.AppendJsonString(value);
+        output.Append(',');
+      }
+      output.Append("\"error\":\"a solution could not be found\"}\n");
+    }
+  } else if (solution) {
+    satisfactory::WriteCsv(output, *solution, scenario, options.numbers);
+  }
+  return std::string(output.view());
+}
+
+// Checks the certificate of a solution, reporting the outcome. Returns false if
+// it does not prove the solution optimal, but true if there is no solution or
+// no certificate to check.
+bool Certify(std::optional<std::string_view> name,
+             const satisfactory::Input& input,
+             std::span<const satisfactory::Demand> demands,
+             const std::optional<satisfactory::Solution>& solution,
+             const std::optional<satisfactory::Certificate>& certificate) {
+  if (!solution) return true;
+  std::ostringstream output;
+  if (name) output << *name << ": ";
+  std::optional<std::string> error;
+  if (!certificate) {
+    output << "There is no certificate for this solution.\n";
+  } else if (error = satisfactory::CheckCertificate(input, demands, *solution,
+                                                    *certificate)) {
+    output << "The certificate does not prove the solution optimal: " << *error
+           << ".\n";
+  } else {
+    output << "The certificate proves the solution optimal.\n";
   }
-  return source;
+  std::cerr << output.str();
+  return !error;
 }
 
+// Writes the results for a sequence of scenarios in order, but writes each
+// one as soon as it and all of the scenarios before it have been solved.
+class OrderedWriter {
+ public:
+  explicit OrderedWriter(int n) : pending_(n) {}
+
+  void Write(int i, std::string text) {
+    std::unique_lock lock(mutex_);
+    pending_[i] = std::move(text);
+    const int n = pending_.size();
+    while (next_ < n && pending_[next_]) {
+      std::cout << *pending_[next_];
+      pending_[next_].reset();
+      next_++;
+    }
+    std::cout.flush();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::optional<std::string>> pending_;
+  int next_ = 0;
+};
+
 }  // namespace
 
 int main(int argc, char* argv[]) {
-  if (argc != 2) {
-    std::cerr << "Usage: solver <filename>\n";
+  const Options options = ParseOptions(argc, argv);
+  if (!options.connect.empty()) {
+    return satisfactory::RunClient(options.connect, STDIN_FILENO,
+                                   STDOUT_FILENO)
+               ? 0
+               : 1;
+  }
+  if (!options.trace_file.empty()) satisfactory::StartTracing();
+  satisfactory::ModuleCache modules(options.module_cache);
+  std::optional<satisfactory::SolutionCache> cache;
+  satisfactory::SolveOptions solve_options;
+  solve_options.column_generation = options.column_generation;
+  solve_options.engine = options.engine;
+  solve_options.granularity = options.granularity;
+  solve_options.max_nodes = options.max_nodes;
+  solve_options.objectives = options.objectives;
+  solve_options.sensitivity = options.sensitivity;
+  if (options.time_limit) {
+    solve_options.deadline =
+        std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            *options.time_limit);
+  }
+  if (options.cache_size > 0) {
+    cache.emplace(options.cache_size, options.solution_cache);
+    solve_options.cache = &*cache;
+  }
+  const auto report = [&] {
+    if (cache && options.cache_stats) std::cerr << cache->stats() << '\n';
+    if (!options.trace_file.empty()) {
+      satisfactory::WriteTrace(options.trace_file);
+    }
+  };
+  if (options.serve) {
+    satisfactory::Server server(modules, solve_options, options.numbers,
+                                options.threads);
+    if (options.socket.empty()) {
+      server.Serve(STDIN_FILENO, STDOUT_FILENO);
+      report();
+      return 0;
+    }
+    server.ServeUnixSocket(options.socket);
     return 1;
   }
-  const std::string source = GetContents(argv[1]);
-  const satisfactory::Input input = satisfactory::ParseInput(source);
+  satisfactory::PhaseStats parse;
+  const satisfactory::Input& input = [&]() -> const satisfactory::Input& {
+    const satisfactory::PhaseScope phase(options.stats ? &parse : nullptr);
+    if (options.base_game) return satisfactory::BaseGame();
+    std::string error;
+    const satisfactory::Input* input = modules.Load(options.filename, &error);
+    if (!input) {
+      std::cerr << error << '\n';
+      std::exit(1);
+    }
+    return *input;
+  }();
+  if (options.stats) std::cerr << "Parse: " << parse << '\n';
+  satisfactory::BasisSet bases;
+  const bool use_bases = !options.basis_file.empty();
+  if (use_bases) bases = satisfactory::LoadBases(options.basis_file);
+  // Each basis is read as a warm start before being overwritten with the
+  // new optimal basis.
+  const auto with_basis = [&](std::string_view name,
+                              satisfactory::SolveStats* stats) {
+    satisfactory::SolveOptions result = solve_options;
+    if (options.stats) result.stats = stats;
+    if (use_bases) {
+      satisfactory::Basis& basis = bases[std::string(name)];
+      result.warm_start = &basis;
+      result.final_basis = &basis;
+    }
+    return result;
+  };
+  const auto save = [&] {
+    if (use_bases) satisfactory::SaveBases(options.basis_file, bases);
+  };
+  if (options.format == satisfactory::Format::kCsv) {
+    satisfactory::OutputBuffer header;
+    satisfactory::WriteCsvHeader(header);
+    std::cout << header.view();
+  }
+  if (options.sweep) {
+    // Each breakpoint is formatted like a scenario named after its t.
+    satisfactory::SolveStats stats;
+    const std::vector<satisfactory::Breakpoint> breakpoints =
+        satisfactory::Sweep(input, {}, input.demands, options.sweep->first,
+                            options.sweep->second,
+                            options.stats ? &stats : nullptr);
+    if (breakpoints.empty()) Format(options, std::nullopt, std::nullopt);
+    for (const auto& [t, solution] : breakpoints) {
+      std::ostringstream name;
+      name << "t = " << t;
+      std::cout << Format(options, name.str(), solution);
+    }
+    if (!breakpoints.empty() && breakpoints.back().t < options.sweep->second) {
+      std::cerr << "The demands cannot be met past t = "
+                << breakpoints.back().t << ".\n";
+    }
+    if (options.stats) std::cerr << stats;
+    report();
+    return breakpoints.empty() ? 1 : 0;
+  }
+  if (!input.scenarios.empty()) {
+    const int n = input.scenarios.size();
+    std::vector<satisfactory::SolveStats> stats(n);
+    std::vector<satisfactory::SolveOptions> scenario_options;
+    const std::unique_ptr<bool[]> stopped(new bool[n]());
+    std::vector<std::optional<satisfactory::Certificate>> certificates(n);
+    for (int i = 0; i < n; i++) {
+      scenario_options.push_back(
+          with_basis(input.scenarios[i].name, &stats[i]));
+      scenario_options.back().stopped = &stopped[i];
+      if (options.certify) {
+        scenario_options.back().certificate = &certificates[i];
+      }
+    }
+    OrderedWriter writer(n);
+    std::mutex status_mutex;
+    int status = 0;
+    satisfactory::SolveScenarios(
+        input, scenario_options,
+        [&](int i, std::optional<satisfactory::Solution> solution) {
+          const bool certified =
+              !options.certify ||
+              Certify(input.scenarios[i].name, input,
+                      input.scenarios[i].demands, solution, certificates[i]);
+          if (!solution || !certified) {
+            std::unique_lock lock(status_mutex);
+            status = 1;
+          }
+          std::string text;
+          {
+            const satisfactory::PhaseScope phase(&stats[i].print);
+            text = Format(options, input.scenarios[i].name, solution,
+                          stopped[i]);
+          }
+          writer.Write(i, std::move(text));
+        });
+    for (int i = 0; options.stats && i < n; i++) {
+      std::cerr << input.scenarios[i].name << ": " << stats[i];
+    }
+    report();
+    save();
+    return status;
+  }
+  satisfactory::SolveStats stats;
+  satisfactory::SolveOptions single_options = with_basis("", &stats);
+  // Without scenarios to solve in parallel, the independent blocks of the
+  // problem are solved in parallel instead.
+  single_options.threads = options.threads;
+  bool stopped = false;
+  single_options.stopped = &stopped;
+  std::optional<satisfactory::Certificate> certificate;
+  if (options.certify) single_options.certificate = &certificate;
   const std::optional<satisfactory::Solution> solution =
-      satisfactory::Solve(input);
-  if (!solution) {
-    std::cerr << "A solution could not be found. Is a recipe missing?\n";
-    return 1;
+      satisfactory::Solve(input, input.demands, single_options);
+  const bool certified =
+      !options.certify ||
+      Certify(std::nullopt, input, input.demands, solution, certificate);
+  std::string text;
+  {
+    const satisfactory::PhaseScope phase(&stats.print);
+    text = Format(options, std::nullopt, solution, stopped);
   }
-  std::cout << *solution << "\n";
+  std::cout << text;
+  if (options.stats) std::cerr << stats;
+  report();
+  save();
+  return solution && certified ? 0 : 1;
 }
@@ -0,0 +1,252 @@
+#include "modular.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <utility>
+
+#include "thread_pool.hpp"
+#include "trace.hpp"
+
+namespace satisfactory {
+namespace {
+
+__extension__ typedef unsigned __int128 Product;
+
+// The largest primes below 2^62. Their residues and the products of two
+// residues fit in machine words, and their product is wide enough to recover
+// any fraction whose numerator and denominator fit in a Rational.
+constexpr std::uint64_t kPrimes[] = {
+    (std::uint64_t(1) << 62) - 57,  (std::uint64_t(1) << 62) - 87,
+    (std::uint64_t(1) << 62) - 117, (std::uint64_t(1) << 62) - 143,
+    (std::uint64_t(1) << 62) - 153, (std::uint64_t(1) << 62) - 167,
+    (std::uint64_t(1) << 62) - 171, (std::uint64_t(1) << 62) - 195};
+constexpr int kNumPrimes = std::size(kPrimes);
+
+// The primes of the first round, and how many more each further round adds.
+// Most solutions only have small numerators and denominators, which two primes
+// are enough to recover.
+constexpr int kPrimesPerRound = 2;
+
+// Wide enough for the product of all of the primes.
+using Wide = Int<512>;
+// Wide enough to check the solution exactly: the products of its entries with
+// those of the system, summed over a row.
+using Wider = Int<1024>;
+
+std::uint64_t MultiplyMod(std::uint64_t a, std::uint64_t b, std::uint64_t p) {
+  return static_cast<std::uint64_t>(static_cast<Product>(a) * b % p);
+}
+
+std::uint64_t InverseMod(std::uint64_t a, std::uint64_t p) {
+  // By Fermat's little theorem, a^(p - 2) is the inverse of a.
+  std::uint64_t result = 1;
+  for (std::uint64_t e = p - 2; e > 0; e >>= 1) {
+    if (e & 1) result = MultiplyMod(result, a, p);
+    a = MultiplyMod(a, a, p);
+  }
+  return result;
+}
+
+template <int n>
+std::uint64_t Residue(const Int<n>& x, std::uint64_t p) {
+  const std::span<const std::uint32_t> words = x.magnitude().words();
+  std::uint64_t result = 0;
+  for (auto word = words.rbegin(); word != words.rend(); ++word) {
+    result = static_cast<std::uint64_t>(
+        ((static_cast<Product>(result) << 32) | *word) % p);
+  }
+  return x.negative() && result != 0 ? p - result : result;
+}
+
+// Converts between widths, which must be wide enough for the value.
+template <int m, int n>
+Int<m> Convert(const Int<n>& x) {
+  Uint<m> magnitude;
+  const std::span<const std::uint32_t> from = x.magnitude().words();
+  const std::span<std::uint32_t> to = magnitude.words();
+  const std::size_t size = std::min(from.size(), to.size());
+  assert(std::all_of(from.begin() + size, from.end(),
+                     [](std::uint32_t word) { return word == 0; }));
+  std::copy(from.begin(), from.begin() + size, to.begin());
+  return x.negative() ? -Int<m>(magnitude) : Int<m>(magnitude);
+}
+
+// Solves the system modulo p by Gaussian elimination. Returns std::nullopt if
+// p divides a denominator or if the matrix is singular modulo p, which for
+// a non-singular matrix only happens if p divides its determinant.
+std::optional<std::vector<std::uint64_t>> SolveModulo(
+    const Table<Rational>& system, std::uint64_t p) {
+  const int m = system.height();
+  Table<std::uint64_t> a(m + 1, m);
+  for (int y = 0; y < m; y++) {
+    for (int x = 0; x <= m; x++) {
+      const Rational& value = system[y][x];
+      if (value == 0) continue;
+      const std::uint64_t denominator = Residue(value.denominator(), p);
+      if (denominator == 0) return std::nullopt;
+      a[y][x] = MultiplyMod(Residue(value.numerator(), p),
+                            InverseMod(denominator, p), p);
+    }
+  }
+  for (int k = 0; k < m; k++) {
+    int pivot = k;
+    while (pivot < m && a[pivot][k] == 0) pivot++;
+    if (pivot == m) return std::nullopt;
+    if (pivot != k) {
+      std::swap_ranges(a[k].begin(), a[k].end(), a[pivot].begin());
+    }
+    const std::uint64_t inverse = InverseMod(a[k][k], p);
+    for (int x = k; x <= m; x++) a[k][x] = MultiplyMod(a[k][x], inverse, p);
+    for (int y = 0; y < m; y++) {
+      const std::uint64_t factor = a[y][k];
+      if (y == k || factor == 0) continue;
+      for (int x = k; x <= m; x++) {
+        const std::uint64_t subtrahend = MultiplyMod(factor, a[k][x], p);
+        a[y][x] = a[y][x] >= subtrahend ? a[y][x] - subtrahend
+                                        : a[y][x] + (p - subtrahend);
+      }
+    }
+  }
+  std::vector<std::uint64_t> solution(m);
+  for (int y = 0; y < m; y++) solution[y] = a[y][m];
+  return solution;
+}
+
+// Combines the residues of a value modulo the primes into the value modulo
+// their product, by Garner's algorithm: the value is expanded in the mixed
+// radix of the primes, whose digits only need arithmetic modulo each prime.
+Wide Combine(std::span<const std::uint64_t> primes,
+             std::span<const std::uint64_t> residues) {
+  const int k = primes.size();
+  std::vector<std::uint64_t> digits(k);
+  for (int i = 0; i < k; i++) {
+    const std::uint64_t p = primes[i];
+    // The value of the lower digits modulo p, and the product of the lower
+    // primes modulo p.
+    std::uint64_t lower = 0, radix = 1;
+    for (int j = 0; j < i; j++) {
+      lower = (lower + MultiplyMod(digits[j] % p, radix, p)) % p;
+      radix = MultiplyMod(radix, primes[j] % p, p);
+    }
+    const std::uint64_t difference = (residues[i] + p - lower) % p;
+    digits[i] = MultiplyMod(difference, InverseMod(radix, p), p);
+  }
+  Wide value = 0;
+  for (int i = k - 1; i >= 0; i--) value = value * primes[i] + digits[i];
+  return value;
+}
+
+// Returns the fraction n / d with |n| and d at most sqrt(modulus / 2) whose
+// residue is the given value, if there is one, by the extended Euclidean
+// algorithm stopped halfway. There is at most one such fraction, so once the
+// product of the primes is large enough, this is the solution.
+std::optional<Rational> Reconstruct(const Wide& value, const Wide& modulus) {
+  Uint<512> power = 1;
+  power <<= (bit_width(modulus) - 2) / 2;
+  const Wide bound = power;
+  Wide r0 = modulus, r1 = value, t0 = 0, t1 = 1;
+  while (r1 > bound) {
+    const Wide q = r0 / r1;
+    r0 = std::exchange(r1, r0 - q * r1);
+    t0 = std::exchange(t1, t0 - q * t1);
+  }
+  if (t1 == 0 || (t1 < 0 ? -t1 : t1) > bound) return std::nullopt;
+  if (t1 < 0) {
+    t1 = -t1;
+    if (r1 != 0) r1 = -r1;
+  }
+  if (gcd(r1, t1) != 1) return std::nullopt;
+  // Leave room for the arithmetic of the solver.
+  if (bit_width(r1) > 126 || bit_width(t1) > 126) return std::nullopt;
+  return Rational(Convert<128>(r1), Convert<128>(t1));
+}
+
+// A fraction in wide integers, for checking the solution without overflow.
+struct Fraction {
+  Wider numerator = 0, denominator = 1;
+
+  // Adds a * b.
+  void AddProduct(const Rational& a, const Rational& b) {
+    const Wider n =
+        Convert<1024>(a.numerator()) * Convert<1024>(b.numerator());
+    const Wider d =
+        Convert<1024>(a.denominator()) * Convert<1024>(b.denominator());
+    numerator = numerator * d + n * denominator;
+    denominator *= d;
+    const Wider divisor = gcd(numerator, denominator);
+    numerator /= divisor;
+    denominator /= divisor;
+  }
+};
+
+// Returns whether the solution satisfies the system exactly. Returns false if
+// the sums are too wide to check, which is unlikely for a solution whose
+// entries fit in a Rational.
+bool Check(const Table<Rational>& system, std::span<const Rational> solution) {
+  const int m = system.height();
+  for (int y = 0; y < m; y++) {
+    Fraction sum;
+    for (int x = 0; x < m; x++) {
+      if (system[y][x] == 0 || solution[x] == 0) continue;
+      sum.AddProduct(system[y][x], solution[x]);
+      if (bit_width(sum.denominator) > 512) return false;
+    }
+    sum.AddProduct(-system[y][m], 1);
+    if (sum.numerator != 0) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+std::optional<std::vector<Rational>> SolveModular(const Table<Rational>& system,
+                                                  int num_threads,
+                                                  int* primes) {
+  const TraceSpan span("SolveModular");
+  const int m = system.height();
+  assert(system.width() == m + 1);
+  // The primes which were used, and the solution modulo each of them.
+  std::vector<std::uint64_t> used;
+  std::vector<std::vector<std::uint64_t>> residues;
+  for (int next = 0; next < kNumPrimes;) {
+    const int count = std::min(kPrimesPerRound, kNumPrimes - next);
+    std::vector<std::optional<std::vector<std::uint64_t>>> round(count);
+    ParallelFor(
+        count,
+        [&](int i) { round[i] = SolveModulo(system, kPrimes[next + i]); },
+        num_threads);
+    for (int i = 0; i < count; i++) {
+      if (!round[i]) continue;
+      used.push_back(kPrimes[next + i]);
+      residues.push_back(std::move(*round[i]));
+    }
+    next += count;
+    if (primes) *primes = next;
+    // A non-singular matrix is only singular modulo the rare primes which
+    // divide its determinant, so the matrix is taken to be singular if it is
+    // modulo every prime of the first round.
+    if (used.empty()) return std::nullopt;
+    Wide modulus = 1;
+    for (std::uint64_t p : used) modulus *= p;
+    std::vector<Rational> solution(m);
+    bool recovered = true;
+    std::vector<std::uint64_t> values(used.size());
+    for (int x = 0; x < m && recovered; x++) {
+      for (std::size_t i = 0; i < used.size(); i++) values[i] = residues[i][x];
+      const std::optional<Rational> value =
+          Reconstruct(Combine(used, values), modulus);
+      if (value) {
+        solution[x] = *value;
+      } else {
+        recovered = false;
+      }
+    }
+    if (recovered && Check(system, solution)) return solution;
+  }
+  return std::nullopt;
+}
+
+}  // namespace satisfactory
@@ -0,0 +1,29 @@
+#ifndef MODULAR_HPP_
+#define MODULAR_HPP_
+
+#include "rational.hpp"
+#include "table.hpp"
+
+#include <optional>
+#include <vector>
+
+namespace satisfactory {
+
+// Solves the square linear system A x = b exactly, given the augmented matrix
+// [A b] with a row per equation. Rather than eliminating in Rational, whose
+// entries grow with every step, the system is solved modulo several 62-bit
+// primes, one prime per thread, using only machine-word arithmetic. The
+// residues are combined by the Chinese remainder theorem, and each entry of x
+// is recovered as the fraction with the smallest numerator and denominator
+// which has its combined residue. Primes are added until the recovered x
+// satisfies the system exactly, checked in wide integers.
+//
+// If primes is non-null, it receives the number of primes used. Returns
+// std::nullopt if A is singular, or if x cannot be represented as Rational.
+std::optional<std::vector<Rational>> SolveModular(const Table<Rational>& system,
+                                                  int num_threads = 1,
+                                                  int* primes = nullptr);
+
+}  // namespace satisfactory
+
+#endif  // MODULAR_HPP_
@@ -0,0 +1,264 @@
+#include "module.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <optional>
+
+#include "hash.hpp"
+#include "parser.hpp"
+#include "serialize.hpp"
+
+namespace satisfactory {
+namespace {
+
+// Bumped whenever the encoding of a parsed module changes.
+constexpr std::uint64_t kModuleMagic = 0x32'444f'4d54'4153;  // "SATMOD2"
+
+std::optional<std::string> ReadFile(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return std::nullopt;
+  return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+class ModuleWriter {
+ public:
+  explicit ModuleWriter(std::string_view source) : source_(source) {}
+
+  void WriteView(std::string_view view) {
+    writer_.WriteU32(view.data() - source_.data());
+    writer_.WriteU32(view.size());
+  }
+
+  void WriteRates(const std::map<std::string_view, Rational>& rates) {
+    writer_.WriteU32(rates.size());
+    for (const auto& [resource, quantity] : rates) {
+      WriteView(resource);
+      writer_.WriteRational(quantity);
+    }
+  }
+
+  void WriteDemands(std::span<const Demand> demands) {
+    writer_.WriteU32(demands.size());
+    for (const auto& [name, rate] : demands) {
+      WriteView(name);
+      writer_.WriteRational(rate);
+    }
+  }
+
+  void WriteInput(const Input& input) {
+    writer_.WriteU64(kModuleMagic);
+    writer_.WriteU64(Fnv1a(source_));
+    writer_.WriteU32(source_.size());
+    writer_.WriteU32(input.imports.size());
+    for (std::string_view path : input.imports) WriteView(path);
+    writer_.WriteU32(input.recipes.size());
+    for (const Recipe& recipe : input.recipes) {
+      WriteRates(recipe.inputs);
+      WriteRates(recipe.outputs);
+      writer_.WriteRational(recipe.duration);
+      writer_.WriteRational(recipe.cost);
+      writer_.WriteU32(recipe.limit.has_value());
+      if (recipe.limit) writer_.WriteRational(*recipe.limit);
+    }
+    WriteDemands(input.demands);
+    writer_.WriteU32(input.scenarios.size());
+    for (const Scenario& scenario : input.scenarios) {
+      WriteView(scenario.name);
+      WriteDemands(scenario.demands);
+    }
+    WriteDemands(input.limits);
+  }
+
+  std::string& buffer() { return writer_.buffer(); }
+
+ private:
+  std::string_view source_;
+  Writer writer_;
+};
+
+class ModuleReader {
+ public:
+  ModuleReader(std::string_view data, std::string_view source)
+      : reader_(data), source_(source) {}
+
+  std::string_view ReadView() {
+    const std::uint32_t offset = reader_.ReadU32();
+    const std::uint32_t size = reader_.ReadU32();
+    if (offset > source_.size() || size > source_.size() - offset) {
+      ok_ = false;
+      return {};
+    }
+    return source_.substr(offset, size);
+  }
+
+  // Every counted item takes at least one byte, so counts are bounded by the
+  // number of bytes left to read, so that a corrupt file cannot trigger an
+  // allocation larger than its remaining data.
+  std::uint32_t ReadCount() {
+    const std::uint32_t count = reader_.ReadU32();
+    if (count > reader_.size()) ok_ = false;
+    return ok() ? count : 0;
+  }
+
+  std::map<std::string_view, Rational> ReadRates() {
+    std::map<std::string_view, Rational> rates;
+    const std::uint32_t n = ReadCount();
+    for (std::uint32_t i = 0; i < n; i++) {
+      const std::string_view resource = ReadView();
+      rates.emplace(resource, reader_.ReadRational());
+    }
+    return rates;
+  }
+
+  std::vector<Demand> ReadDemands() {
+    std::vector<Demand> demands;
+    const std::uint32_t n = ReadCount();
+    for (std::uint32_t i = 0; i < n; i++) {
+      const std::string_view name = ReadView();
+      demands.push_back(Demand(name, reader_.ReadRational()));
+    }
+    return demands;
+  }
+
+  bool ReadInput(Input& input) {
+    if (reader_.ReadU64() != kModuleMagic) return false;
+    if (reader_.ReadU64() != Fnv1a(source_)) return false;
+    if (reader_.ReadU32() != source_.size()) return false;
+    const std::uint32_t num_imports = ReadCount();
+    for (std::uint32_t i = 0; i < num_imports; i++) {
+      input.imports.push_back(ReadView());
+    }
+    const std::uint32_t num_recipes = ReadCount();
+    for (std::uint32_t i = 0; i < num_recipes && ok(); i++) {
+      Recipe& recipe = input.recipes.emplace_back();
+      recipe.inputs = ReadRates();
+      recipe.outputs = ReadRates();
+      recipe.duration = reader_.ReadRational();
+      recipe.cost = reader_.ReadRational();
+      if (reader_.ReadU32()) recipe.limit = reader_.ReadRational();
+    }
+    input.demands = ReadDemands();
+    const std::uint32_t num_scenarios = ReadCount();
+    for (std::uint32_t i = 0; i < num_scenarios && ok(); i++) {
+      const std::string_view name = ReadView();
+      input.scenarios.push_back(
+          Scenario{.name = name, .demands = ReadDemands()});
+    }
+    input.limits = ReadDemands();
+    return ok() && reader_.empty();
+  }
+
+  bool ok() const { return ok_ && reader_.ok(); }
+
+ private:
+  Reader reader_;
+  std::string_view source_;
+  bool ok_ = true;
+};
+
+}  // namespace
+
+std::string EncodeModule(const Module& module) {
+  ModuleWriter writer(module.source);
+  writer.WriteInput(module.input);
+  return std::move(writer.buffer());
+}
+
+bool DecodeModule(std::string_view data, Module& module) {
+  Input input;
+  if (!ModuleReader(data, module.source).ReadInput(input)) return false;
+  module.input = std::move(input);
+  return true;
+}
+
+ModuleCache::ModuleCache(std::filesystem::path cache_directory)
+    : cache_directory_(std::move(cache_directory)) {}
+
+const Input* ModuleCache::Load(const std::filesystem::path& path,
+                               std::string* error) {
+  std::string message;
+  if (!error) error = &message;
+  const std::filesystem::path key = std::filesystem::weakly_canonical(path);
+  std::unique_lock lock(mutex_);
+  if (auto i = resolved_.find(key); i != resolved_.end()) {
+    return i->second.get();
+  }
+  const Module* const module = LoadModule(key, *error);
+  if (!module) return nullptr;
+  auto input = std::make_unique<Input>(module->input);
+  std::map<std::filesystem::path, bool> visited = {{key, false}};
+  Input imported;
+  if (!AddImports(*module, visited, imported, *error)) return nullptr;
+  imported.recipes.insert(imported.recipes.end(),
+                          module->input.recipes.begin(),
+                          module->input.recipes.end());
+  imported.limits.insert(imported.limits.end(), module->input.limits.begin(),
+                         module->input.limits.end());
+  input->recipes = std::move(imported.recipes);
+  input->limits = std::move(imported.limits);
+  return resolved_.emplace(key, std::move(input)).first->second.get();
+}
+
+const Module* ModuleCache::LoadModule(const std::filesystem::path& path,
+                                      std::string& error) {
+  if (auto i = modules_.find(path); i != modules_.end()) {
+    return i->second.get();
+  }
+  auto module = std::make_unique<Module>();
+  module->path = path;
+  std::optional<std::string> source = ReadFile(path);
+  if (!source) {
+    error = "Failed to read " + path.string();
+    return nullptr;
+  }
+  module->source = std::move(*source);
+  std::filesystem::path cache_file;
+  if (!cache_directory_.empty()) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.module",
+                  static_cast<unsigned long long>(Fnv1a(module->source)));
+    cache_file = cache_directory_ / name;
+  }
+  // A cached module which cannot be read or decoded is parsed again.
+  const std::optional<std::string> cached =
+      cache_file.empty() ? std::nullopt : ReadFile(cache_file);
+  if (!cached || !DecodeModule(*cached, *module)) {
+    std::optional<Input> input =
+        ParseInput(module->source, path.string(), &error);
+    if (!input) return nullptr;
+    module->input = std::move(*input);
+    if (!cache_file.empty()) {
+      WriteFileAtomically(cache_file, EncodeModule(*module));
+    }
+  }
+  return modules_.emplace(path, std::move(module)).first->second.get();
+}
+
+bool ModuleCache::AddImports(const Module& module,
+                             std::map<std::filesystem::path, bool>& visited,
+                             Input& output, std::string& error) {
+  for (std::string_view import : module.input.imports) {
+    const std::filesystem::path path = std::filesystem::weakly_canonical(
+        module.path.parent_path() / std::filesystem::path(import));
+    const auto [i, inserted] = visited.emplace(path, false);
+    if (!inserted) {
+      if (i->second) continue;
+      error = module.path.string() + ": error: import cycle through " +
+              path.string();
+      return false;
+    }
+    const Module* const imported = LoadModule(path, error);
+    if (!imported || !AddImports(*imported, visited, output, error)) {
+      return false;
+    }
+    output.recipes.insert(output.recipes.end(),
+                          imported->input.recipes.begin(),
+                          imported->input.recipes.end());
+    output.limits.insert(output.limits.end(), imported->input.limits.begin(),
+                         imported->input.limits.end());
+    i->second = true;
+  }
+  return true;
+}
+
+}  // namespace satisfactory
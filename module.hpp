@@ -0,0 +1,69 @@
+#ifndef MODULE_HPP_
+#define MODULE_HPP_
+
+#include "data.hpp"
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace satisfactory {
+
+// A source file together with its parsed contents. Every string_view in the
+// input refers to the source, which is owned by the module. The imports of the
+// input are not resolved.
+struct Module {
+  std::filesystem::path path;
+  std::string source;
+  Input input;
+};
+
+// Loads input files and the files that they import. Each file is read and
+// parsed at most once per cache, so many inputs can share a single recipe
+// library. The cache is safe to use from multiple threads.
+class ModuleCache {
+ public:
+  // If cache_directory is non-empty, parsed modules are additionally persisted
+  // there, keyed by a hash of their contents, and reused by later processes.
+  explicit ModuleCache(std::filesystem::path cache_directory = {});
+
+  // Loads the given file and resolves its imports. Import paths are relative
+  // to the directory of the importing file. The result contains the recipes of
+  // every transitively imported file, each included once in dependency order,
+  // followed by the recipes of the file itself. Only the file itself
+  // contributes demands and scenarios. The returned input remains valid for
+  // the lifetime of the cache. If a file cannot be read or parsed, or the
+  // imports form a cycle, returns null and sets error, if non-null, to
+  // a message describing the problem. Nothing is cached for such a file, so
+  // loading it again will try again.
+  const Input* Load(const std::filesystem::path& path,
+                    std::string* error = nullptr);
+
+ private:
+  // Returns null and sets error if the module cannot be read or parsed.
+  const Module* LoadModule(const std::filesystem::path& path,
+                           std::string& error);
+  // Appends the recipes and limits of the module's imports to the output,
+  // skipping any module which has already been visited. Returns false and
+  // sets error if an import cannot be loaded or forms a cycle.
+  bool AddImports(const Module& module,
+                  std::map<std::filesystem::path, bool>& visited,
+                  Input& output, std::string& error);
+
+  std::filesystem::path cache_directory_;
+  std::mutex mutex_;
+  std::map<std::filesystem::path, std::unique_ptr<Module>> modules_;
+  std::map<std::filesystem::path, std::unique_ptr<Input>> resolved_;
+};
+
+// Encodes the parsed input of a module in a compact binary form which refers to
+// the source by offset, and decodes it again. Decoding returns false if the
+// data is malformed or was produced from a different source.
+std::string EncodeModule(const Module& module);
+bool DecodeModule(std::string_view data, Module& module);
+
+}  // namespace satisfactory
+
+#endif  // MODULE_HPP_
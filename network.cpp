@@ -0,0 +1,301 @@
+#include "network.hpp"
+
+#include <algorithm>
+#include <map>
+
+#include "trace.hpp"
+
+namespace satisfactory {
+namespace {
+
+// A recipe as an arc of the network: using the recipe once turns input_rate of
+// the input resource per second into output_rate of the output resource.
+struct Arc {
+  // The input and output resources, or -1 for none.
+  int input = -1, output = -1;
+  Rational input_rate, output_rate;
+  Rational cost;
+};
+
+// Returns the arc of each recipe, or std::nullopt if some recipe has several
+// inputs or several outputs.
+std::optional<std::vector<Arc>> GetArcs(
+    const Input& input, std::span<const std::string_view> resources) {
+  const auto index = [&](std::string_view name) -> int {
+    return std::ranges::lower_bound(resources, name) - resources.begin();
+  };
+  std::vector<Arc> arcs;
+  arcs.reserve(input.recipes.size());
+  for (const Recipe& recipe : input.recipes) {
+    // Only net quantities matter, as in the tableau.
+    std::map<int, Rational> quantities;
+    for (const auto& [resource, quantity] : recipe.inputs) {
+      quantities[index(resource)] -= quantity;
+    }
+    for (const auto& [resource, quantity] : recipe.outputs) {
+      quantities[index(resource)] += quantity;
+    }
+    Arc& arc = arcs.emplace_back();
+    arc.cost = recipe.cost;
+    for (const auto& [resource, quantity] : quantities) {
+      if (quantity < 0) {
+        if (arc.input != -1) return std::nullopt;
+        arc.input = resource;
+        arc.input_rate = -quantity / recipe.duration;
+      } else if (quantity > 0) {
+        if (arc.output != -1) return std::nullopt;
+        arc.output = resource;
+        arc.output_rate = quantity / recipe.duration;
+      }
+    }
+  }
+  return arcs;
+}
+
+// The state of the network simplex: producer[j] is the recipe which produces
+// resource j, or -1 if it cannot be produced. The price of a resource is the
+// cost of its producer per unit of output, plus the price of the input needed
+// for that unit.
+class Network {
+ public:
+  Network(std::vector<Arc> arcs, int n)
+      : arcs_(std::move(arcs)), producer_(n, -1), price_(n) {}
+
+  // Chooses an initial producer for each resource which can be produced,
+  // taking the resources in rounds so that the producers cannot form a cycle.
+  void Initialize() {
+    for (bool changed = true; changed;) {
+      changed = false;
+      std::vector<int> next = producer_;
+      for (int i = 0; i < std::ssize(arcs_); i++) {
+        const Arc& arc = arcs_[i];
+        if (arc.output == -1 || next[arc.output] != -1) continue;
+        if (arc.input != -1 && producer_[arc.input] == -1) continue;
+        next[arc.output] = i;
+        changed = true;
+      }
+      producer_ = std::move(next);
+    }
+  }
+
+  // Computes the prices of the resources for the current producers. Following
+  // the inputs of the producers from any resource either reaches a source
+  // recipe or goes around a cycle, which must make more of each resource than
+  // it uses. Returns false if it does not.
+  bool Price() {
+    const int n = producer_.size();
+    enum State : char { kUnvisited, kVisiting, kDone };
+    std::vector<State> state(n, kUnvisited);
+    std::vector<int> path;
+    for (int start = 0; start < n; start++) {
+      if (producer_[start] == -1 || state[start] != kUnvisited) continue;
+      path.clear();
+      int j = start;
+      while (j != -1 && state[j] == kUnvisited) {
+        state[j] = kVisiting;
+        path.push_back(j);
+        j = Next(j);
+      }
+      if (j != -1 && state[j] == kVisiting) {
+        // Around the cycle, price[j] = total + factor * price[j].
+        Rational total = 0, factor = 1;
+        for (auto k = std::ranges::find(path, j); k != path.end(); ++k) {
+          total += factor * Cost(*k);
+          factor *= Factor(*k);
+        }
+        if (factor >= 1) return false;
+        price_[j] = total / (1 - factor);
+        state[j] = kDone;
+      }
+      for (auto k = path.rbegin(); k != path.rend(); ++k) {
+        if (state[*k] == kDone) continue;
+        const int input = Next(*k);
+        price_[*k] = Cost(*k);
+        if (input != -1) price_[*k] += Factor(*k) * price_[input];
+        state[*k] = kDone;
+      }
+    }
+    return true;
+  }
+
+  // Switches the producer of each resource to the recipe which produces it
+  // most cheaply at the current prices, if that is cheaper than its current
+  // producer. Returns whether any producer changed.
+  bool Improve() {
+    std::vector<Rational> best = price_;
+    std::vector<int> next = producer_;
+    bool changed = false;
+    for (int i = 0; i < std::ssize(arcs_); i++) {
+      const Arc& arc = arcs_[i];
+      if (arc.output == -1) continue;
+      if (arc.input != -1 && producer_[arc.input] == -1) continue;
+      Rational price = arc.cost;
+      if (arc.input != -1) price += arc.input_rate * price_[arc.input];
+      price /= arc.output_rate;
+      if (next[arc.output] == -1 || price < best[arc.output]) {
+        best[arc.output] = price;
+        next[arc.output] = i;
+        changed = true;
+      }
+    }
+    producer_ = std::move(next);
+    return changed;
+  }
+
+  // Returns the use of each recipe which meets the demands with the current
+  // producers, or std::nullopt if some demand cannot be produced.
+  std::optional<std::vector<Rational>> Uses(std::span<const Rational> demands) {
+    const int n = producer_.size();
+    // The total production required of each resource, including the inputs
+    // of the producers of other resources.
+    std::vector<Rational> required(demands.begin(), demands.end());
+    for (int j = 0; j < n; j++) {
+      if (required[j] > 0 && producer_[j] == -1) return std::nullopt;
+    }
+    // Resources which are not the input of any producer are settled first, and
+    // then those whose consumers have all been settled.
+    std::vector<int> consumers(n, 0);
+    for (int j = 0; j < n; j++) {
+      if (producer_[j] != -1 && Next(j) != -1) consumers[Next(j)]++;
+    }
+    std::vector<int> ready;
+    for (int j = 0; j < n; j++) {
+      if (producer_[j] != -1 && consumers[j] == 0) ready.push_back(j);
+    }
+    std::vector<bool> settled(n, false);
+    while (!ready.empty()) {
+      const int j = ready.back();
+      ready.pop_back();
+      settled[j] = true;
+      const int input = Next(j);
+      if (input == -1) continue;
+      required[input] += Factor(j) * required[j];
+      if (--consumers[input] == 0) ready.push_back(input);
+    }
+    // The remaining resources lie on cycles, and only supply each other.
+    for (int start = 0; start < n; start++) {
+      if (producer_[start] == -1 || settled[start]) continue;
+      // Going around the cycle from start, the requirement for each resource
+      // is offset + scale * required[start].
+      Rational offset = 0, scale = 1;
+      int j = start;
+      for (int k = Next(start); k != start; k = Next(k)) {
+        offset = required[k] + Factor(j) * offset;
+        scale *= Factor(j);
+        j = k;
+      }
+      required[start] = (required[start] + Factor(j) * offset) /
+                        (1 - Factor(j) * scale);
+      settled[start] = true;
+      for (int k = Next(start), previous = start; k != start;
+           previous = k, k = Next(k)) {
+        required[k] += Factor(previous) * required[previous];
+        settled[k] = true;
+      }
+    }
+    std::vector<Rational> uses(arcs_.size());
+    for (int j = 0; j < n; j++) {
+      if (producer_[j] == -1) continue;
+      uses[producer_[j]] += required[j] / arcs_[producer_[j]].output_rate;
+    }
+    return uses;
+  }
+
+  // Returns the prices of the resources for the current producers, extended
+  // to the resources which cannot be produced so that no recipe has a negative
+  // reduced cost. Their prices must be high enough that recipes which consume
+  // them are not worth using, which can take several rounds, as such recipes
+  // may produce other resources which cannot be produced. Returns std::nullopt
+  // if the rounds do not settle, as when a cycle of such recipes could make
+  // those resources from nothing after all.
+  std::optional<std::vector<Rational>> Prices() const {
+    const int n = producer_.size();
+    std::vector<Rational> prices(n);
+    for (int j = 0; j < n; j++) {
+      if (producer_[j] != -1) prices[j] = price_[j];
+    }
+    for (int round = 0; round <= n; round++) {
+      bool changed = false;
+      for (const Arc& arc : arcs_) {
+        if (arc.input == -1 || producer_[arc.input] != -1) continue;
+        Rational value = -arc.cost;
+        if (arc.output != -1) value += arc.output_rate * prices[arc.output];
+        const Rational price = value / arc.input_rate;
+        if (price > prices[arc.input]) {
+          prices[arc.input] = price;
+          changed = true;
+        }
+      }
+      if (!changed) return prices;
+    }
+    return std::nullopt;
+  }
+
+  std::span<const int> producers() const { return producer_; }
+
+ private:
+  // The input of the producer of resource j, or -1 if it is a source.
+  int Next(int j) const { return arcs_[producer_[j]].input; }
+  // The cost of producer of resource j per unit of output.
+  Rational Cost(int j) const {
+    const Arc& arc = arcs_[producer_[j]];
+    return arc.cost / arc.output_rate;
+  }
+  // The input of the producer of resource j per unit of output.
+  Rational Factor(int j) const {
+    const Arc& arc = arcs_[producer_[j]];
+    return arc.input_rate / arc.output_rate;
+  }
+
+  std::vector<Arc> arcs_;
+  std::vector<int> producer_;
+  std::vector<Rational> price_;
+};
+
+}  // namespace
+
+std::optional<NetworkSolution> SolveNetwork(const Input& input,
+                                            std::span<const Demand> demands) {
+  if (!input.limits.empty()) return std::nullopt;
+  for (const Recipe& recipe : input.recipes) {
+    if (recipe.limit) return std::nullopt;
+  }
+  const std::vector<std::string_view> resources = Resources(input, demands);
+  std::optional<std::vector<Arc>> arcs = GetArcs(input, resources);
+  if (!arcs) return std::nullopt;
+  const TraceSpan span("SolveNetwork");
+  const int n = resources.size();
+  // Demands for the same resource add up, as in the tableau.
+  std::vector<Rational> required(n);
+  for (const auto& [resource, rate] : demands) {
+    required[std::ranges::lower_bound(resources, resource) -
+             resources.begin()] += rate / 60;
+  }
+  if (std::ranges::any_of(required, [](const Rational& x) { return x < 0; })) {
+    return std::nullopt;
+  }
+  Network network(std::move(*arcs), n);
+  network.Initialize();
+  do {
+    // Improvements never create a cycle which uses more than it makes.
+    if (!network.Price()) return std::nullopt;
+  } while (network.Improve());
+  std::optional<std::vector<Rational>> uses = network.Uses(required);
+  if (!uses) return std::nullopt;
+  const std::optional<std::vector<Rational>> prices = network.Prices();
+  if (!prices) return std::nullopt;
+  NetworkSolution solution{
+      .uses = std::move(*uses), .cost = 0, .producers = {}, .prices = {}};
+  for (std::size_t i = 0; i < solution.uses.size(); i++) {
+    solution.cost += input.recipes[i].cost * solution.uses[i];
+  }
+  for (int j = 0; j < n; j++) {
+    const int producer = network.producers()[j];
+    if (producer != -1) solution.producers.push_back({resources[j], producer});
+    const Rational& price = (*prices)[j];
+    if (price != 0) solution.prices.push_back({resources[j], price});
+  }
+  return solution;
+}
+
+}  // namespace satisfactory
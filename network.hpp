@@ -0,0 +1,45 @@
+#ifndef NETWORK_HPP_
+#define NETWORK_HPP_
+
+#include "data.hpp"
+
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace satisfactory {
+
+// The optimal solution to a problem which is a generalized network.
+struct NetworkSolution {
+  std::vector<Rational> uses;
+  Rational cost;
+  // The optimal basis: each resource which can be produced, paired with the
+  // index of the recipe which produces it.
+  std::vector<std::pair<std::string_view, int>> producers;
+  // Prices per unit/s of the resources, at which no recipe would reduce the
+  // cost, which prove the solution optimal. Resources which are not listed
+  // have no price.
+  std::vector<std::pair<std::string_view, Rational>> prices;
+};
+
+// Solves a problem whose recipes each turn at most one resource into exactly
+// one other, counting net quantities, which makes it a generalized network.
+// Such problems are common: miners, smelters and constructors all have a single
+// input and a single output. Rather than using a tableau, the solver chooses a
+// recipe to produce each resource, which gives the resources prices, and then
+// switches to any recipe which would produce a resource more cheaply at those
+// prices until none would. This is the generalized network simplex algorithm,
+// with the chosen recipes forming its spanning trees.
+//
+// Returns std::nullopt if the problem is not a generalized network, if it has
+// limits or negative demands, if a demand can only be met by a cycle of
+// recipes, or if no prices prove the solution optimal, in which case it must
+// be solved on a tableau instead.
+std::optional<NetworkSolution> SolveNetwork(const Input& input,
+                                            std::span<const Demand> demands);
+
+}  // namespace satisfactory
+
+#endif  // NETWORK_HPP_
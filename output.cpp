@@ -0,0 +1,283 @@
+#include "output.hpp"
+
+#include <charconv>
+
+#include "trace.hpp"
+
+namespace satisfactory {
+
+template <typename T>
+void OutputBuffer::AppendChars(const T& value) {
+  using std::to_chars;
+  // Large enough for any int128 or double.
+  char temp[64];
+  const auto [end, error] = to_chars(temp, temp + sizeof(temp), value);
+  data_.append(temp, end);
+}
+
+void OutputBuffer::AppendInt(const int128& value) { AppendChars(value); }
+
+void OutputBuffer::AppendRational(const Rational& value, Numbers numbers) {
+  if (numbers == Numbers::kDecimal) {
+    AppendChars(static_cast<double>(value));
+    return;
+  }
+  AppendInt(value.numerator());
+  if (value.denominator() != 1) {
+    Append('/');
+    AppendInt(value.denominator());
+  }
+}
+
+void OutputBuffer::AppendRecipe(const Recipe& recipe) {
+  const auto append_list = [&](const std::map<std::string_view, Rational>&
+                                   list) {
+    bool first = true;
+    for (const auto& [resource, quantity] : list) {
+      if (!first) Append(" + ");
+      first = false;
+      if (quantity > 0) {
+        AppendRational(quantity, Numbers::kExact);
+        Append(' ');
+        Append(resource);
+      } else {
+        Append('(');
+        Append(resource);
+        Append(')');
+      }
+    }
+  };
+  append_list(recipe.inputs);
+  Append(" -> ");
+  append_list(recipe.outputs);
+  Append(" (");
+  AppendRational(recipe.duration, Numbers::kExact);
+  Append(" s/run, cost ");
+  AppendRational(recipe.cost, Numbers::kExact);
+  if (recipe.limit) {
+    Append(", max ");
+    AppendRational(*recipe.limit, Numbers::kExact);
+  }
+  Append(')');
+}
+
+void OutputBuffer::AppendJsonString(std::string_view text) {
+  constexpr char kHex[] = "0123456789abcdef";
+  Append('"');
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      Append('\\');
+      Append(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      Append("\\u00");
+      Append(kHex[c >> 4]);
+      Append(kHex[c & 0xF]);
+    } else {
+      Append(c);
+    }
+  }
+  Append('"');
+}
+
+void OutputBuffer::AppendCsvField(std::string_view text) {
+  if (text.find_first_of(",\"\n") == text.npos) {
+    Append(text);
+    return;
+  }
+  Append('"');
+  for (char c : text) {
+    if (c == '"') Append('"');
+    Append(c);
+  }
+  Append('"');
+}
+
+namespace {
+
+void AppendJsonNumber(OutputBuffer& output, const Rational& value,
+                      Numbers numbers) {
+  const bool quoted = numbers == Numbers::kExact && value.denominator() != 1;
+  if (quoted) output.Append('"');
+  output.AppendRational(value, numbers);
+  if (quoted) output.Append('"');
+}
+
+void AppendJsonRates(OutputBuffer& output,
+                     const std::map<std::string_view, Rational>& rates,
+                     Numbers numbers) {
+  output.Append('{');
+  bool first = true;
+  for (const auto& [resource, rate] : rates) {
+    if (rate == 0) continue;
+    if (!first) output.Append(',');
+    first = false;
+    output.AppendJsonString(resource);
+    output.Append(':');
+    AppendJsonNumber(output, rate, numbers);
+  }
+  output.Append('}');
+}
+
+// Appends a JSON object with the ends of a range, which are null if unbounded.
+void AppendJsonRange(OutputBuffer& output, const Range& range,
+                     Numbers numbers) {
+  output.Append("{\"lower\":");
+  if (range.lower) {
+    AppendJsonNumber(output, *range.lower, numbers);
+  } else {
+    output.Append("null");
+  }
+  output.Append(",\"upper\":");
+  if (range.upper) {
+    AppendJsonNumber(output, *range.upper, numbers);
+  } else {
+    output.Append("null");
+  }
+  output.Append('}');
+}
+
+void AppendJsonSensitivity(OutputBuffer& output,
+                           const Sensitivity& sensitivity, Numbers numbers) {
+  output.Append("{\"prices\":");
+  AppendJsonRates(output, sensitivity.prices, numbers);
+  output.Append(",\"demand_ranges\":{");
+  bool first = true;
+  for (const auto& [resource, range] : sensitivity.demand_ranges) {
+    if (!first) output.Append(',');
+    first = false;
+    output.AppendJsonString(resource);
+    output.Append(':');
+    AppendJsonRange(output, range, numbers);
+  }
+  output.Append("},\"recipes\":[");
+  const int r = sensitivity.reduced_costs.size();
+  for (int i = 0; i < r; i++) {
+    if (i > 0) output.Append(',');
+    output.Append("{\"recipe\":");
+    output.AppendInt(i);
+    output.Append(",\"reduced_cost\":");
+    AppendJsonNumber(output, sensitivity.reduced_costs[i], numbers);
+    output.Append(",\"cost_range\":");
+    AppendJsonRange(output, sensitivity.cost_ranges[i], numbers);
+    output.Append('}');
+  }
+  output.Append("]}");
+}
+
+void AppendCsvRow(OutputBuffer& output, std::string_view scenario,
+                  std::string_view section, std::string_view key,
+                  const Rational& value, Numbers numbers) {
+  output.AppendCsvField(scenario);
+  output.Append(',');
+  output.Append(section);
+  output.Append(',');
+  output.AppendCsvField(key);
+  output.Append(',');
+  output.AppendRational(value, numbers);
+  output.Append('\n');
+}
+
+}  // namespace
+
+void WriteJsonLine(OutputBuffer& output, const Solution& solution,
+                   std::span<const Tag> tags, Numbers numbers) {
+  const TraceSpan span("WriteJsonLine");
+  output.Append('{');
+  for (const auto& [name, value] : tags) {
+    output.AppendJsonString(name);
+    output.Append(':');
+    output.AppendJsonString(value);
+    output.Append(',');
+  }
+  output.Append("\"cost\":");
+  AppendJsonNumber(output, solution.cost, numbers);
+  output.Append(",\"uses\":[");
+  const int r = solution.uses.size();
+  bool first = true;
+  for (int i = 0; i < r; i++) {
+    if (solution.uses[i] == 0) continue;
+    if (!first) output.Append(',');
+    first = false;
+    output.Append("{\"recipe\":");
+    output.AppendInt(i);
+    output.Append(",\"text\":\"");
+    // Recipe text never needs escaping: it consists of identifiers, numbers
+    // and punctuation.
+    output.AppendRecipe(solution.input->recipes[i]);
+    output.Append("\",\"machines\":");
+    AppendJsonNumber(output, solution.uses[i], numbers);
+    output.Append('}');
+  }
+  output.Append("],\"total\":");
+  AppendJsonRates(output, solution.total, numbers);
+  output.Append(",\"net\":");
+  AppendJsonRates(output, solution.net, numbers);
+  if (solution.sensitivity) {
+    output.Append(",\"sensitivity\":");
+    AppendJsonSensitivity(output, *solution.sensitivity, numbers);
+  }
+  output.Append("}\n");
+}
+
+void WriteCsvHeader(OutputBuffer& output) {
+  output.Append("scenario,section,key,value\n");
+}
+
+void WriteCsv(OutputBuffer& output, const Solution& solution,
+              std::string_view scenario, Numbers numbers) {
+  const TraceSpan span("WriteCsv");
+  const int r = solution.uses.size();
+  // The recipe text is built in a separate buffer so that it can be quoted;
+  // the buffer is reused across rows.
+  thread_local OutputBuffer recipe;
+  for (int i = 0; i < r; i++) {
+    if (solution.uses[i] == 0) continue;
+    recipe.Clear();
+    recipe.AppendRecipe(solution.input->recipes[i]);
+    AppendCsvRow(output, scenario, "use", recipe.view(), solution.uses[i],
+                 numbers);
+  }
+  for (const auto& [resource, rate] : solution.total) {
+    if (rate == 0) continue;
+    AppendCsvRow(output, scenario, "total", resource, rate, numbers);
+  }
+  for (const auto& [resource, rate] : solution.net) {
+    if (rate == 0) continue;
+    AppendCsvRow(output, scenario, "net", resource, rate, numbers);
+  }
+  AppendCsvRow(output, scenario, "cost", "", solution.cost, numbers);
+  if (!solution.sensitivity) return;
+  // Unbounded ends of ranges are left out.
+  const Sensitivity& sensitivity = *solution.sensitivity;
+  for (const auto& [resource, price] : sensitivity.prices) {
+    if (price == 0) continue;
+    AppendCsvRow(output, scenario, "price", resource, price, numbers);
+  }
+  for (const auto& [resource, range] : sensitivity.demand_ranges) {
+    if (range.lower) {
+      AppendCsvRow(output, scenario, "demand_lower", resource, *range.lower,
+                   numbers);
+    }
+    if (range.upper) {
+      AppendCsvRow(output, scenario, "demand_upper", resource, *range.upper,
+                   numbers);
+    }
+  }
+  for (int i = 0; i < r; i++) {
+    recipe.Clear();
+    recipe.AppendRecipe(solution.input->recipes[i]);
+    AppendCsvRow(output, scenario, "reduced_cost", recipe.view(),
+                 sensitivity.reduced_costs[i], numbers);
+    const Range& range = sensitivity.cost_ranges[i];
+    if (range.lower) {
+      AppendCsvRow(output, scenario, "cost_lower", recipe.view(), *range.lower,
+                   numbers);
+    }
+    if (range.upper) {
+      AppendCsvRow(output, scenario, "cost_upper", recipe.view(), *range.upper,
+                   numbers);
+    }
+  }
+}
+
+}  // namespace satisfactory
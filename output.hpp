@@ -0,0 +1,76 @@
+#ifndef OUTPUT_HPP_
+#define OUTPUT_HPP_
+
+#include "data.hpp"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace satisfactory {
+
+// Machine-readable output formats for solutions.
+enum class Format {
+  // The human-readable tables of operator<<.
+  kText,
+  // One JSON object per solution, on a single line.
+  kJsonLines,
+  // One row per value, with the columns "scenario,section,key,value".
+  kCsv,
+};
+
+enum class Numbers {
+  // Exact fractions, such as "49/60". These are strings in JSON.
+  kExact,
+  // The nearest double, such as 0.8166666666666667.
+  kDecimal,
+};
+
+// A growable character buffer which serializers append to. Clearing the buffer
+// keeps its capacity, so a buffer which is reused for many solutions stops
+// allocating once it has grown to fit the largest of them.
+class OutputBuffer {
+ public:
+  void Clear() noexcept { data_.clear(); }
+  std::string_view view() const noexcept { return data_; }
+
+  void Append(char c) { data_.push_back(c); }
+  void Append(std::string_view text) { data_.append(text); }
+  void AppendInt(const int128& value);
+  void AppendRational(const Rational& value, Numbers numbers);
+  // Appends the text of a recipe, as written by operator<<.
+  void AppendRecipe(const Recipe& recipe);
+  // Appends a quoted JSON string.
+  void AppendJsonString(std::string_view text);
+  // Appends a CSV field, quoting it if necessary.
+  void AppendCsvField(std::string_view text);
+
+ private:
+  // Appends a short run of characters produced by to_chars.
+  template <typename T>
+  void AppendChars(const T& value);
+
+  std::string data_;
+};
+
+// Leading fields to attach to each record, such as the scenario name or the id
+// of a server request.
+using Tag = std::pair<std::string_view, std::string_view>;
+
+// Appends a single line holding a JSON object with the given tags followed by
+// the fields "cost", "uses", "total" and "net", and "sensitivity" if the
+// solution has it.
+void WriteJsonLine(OutputBuffer& output, const Solution& solution,
+                   std::span<const Tag> tags, Numbers numbers);
+
+void WriteCsvHeader(OutputBuffer& output);
+// Appends one CSV row for each non-zero recipe use, total rate and net rate,
+// and one for the cost, followed by rows for the sensitivity of the solution
+// if it has it.
+void WriteCsv(OutputBuffer& output, const Solution& solution,
+              std::string_view scenario, Numbers numbers);
+
+}  // namespace satisfactory
+
+#endif  // OUTPUT_HPP_
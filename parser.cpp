@@ -1,196 +1,61 @@
 #include "parser.hpp"
 
-#include <iostream>
+#include <algorithm>
+#include <string>
 
-namespace satisfactory {
-namespace {
-
-bool IsWhitespace(char c) { return c == ' ' || c == '\r' || c == '\n'; }
-bool IsLower(char c) { return 'a' <= c && c <= 'z'; }
-bool IsUpper(char c) { return 'A' <= c && c <= 'Z'; }
-bool IsAlpha(char c) { return IsLower(c) || IsUpper(c); }
-bool IsDigit(char c) { return '0' <= c && c <= '9'; }
-bool IsIdentifier(char c) { return IsAlpha(c) || IsDigit(c); }
-
-class Parser {
- public:
-  Parser(std::string_view source) : remaining_(source) {
-    if (remaining_.empty() || remaining_.back() != '\n') {
-      Advance(remaining_.size());
-      Die("input must end with a newline");
-    }
-  }
-
-  std::int64_t ParseInt() {
-    const std::string_view number = Sequence<IsDigit>("expected an integer");
-    std::int64_t value = 0;
-    for (char c : number) value = 10 * value + (c - '0');
-    return value;
-  }
-
-  Rational ParseRational() {
-    Rational value = ParseInt();
-    if (ConsumePrefix(".")) {
-      Rational unit = 1;
-      for (char c : Sequence<IsDigit>("expected digits after decimal point")) {
-        unit /= 10;
-        value += (c - '0') * unit;
-      }
-      return value;
-    } else if (ConsumePrefix("/")) {
-      return value / ParseInt();
-    } else {
-      return value;
-    }
-  }
-
-  std::pair<std::string_view, Rational> ParseItemCount() {
-    if (ConsumePrefix("(")) {
-      SkipWhitespace();
-      const std::string_view resource_name =
-          Sequence<IsIdentifier>("expected a primitive resource name");
-      SkipWhitespace();
-      if (!ConsumePrefix(")")) Die("expected ')'");
-      return {resource_name, 0};
-    } else {
-      const Rational count = ParseRational();
-      SkipWhitespace();
-      const std::string_view resource_name =
-          Sequence<IsIdentifier>("expected a resource name");
-      return {resource_name, count};
-    }
-  }
-
-  Recipe ParseRecipe() {
-    if (remaining_.empty()) Die("expected recipe");
-    Recipe result;
-    // Parse the inputs.
-    while (true) {
-      result.inputs.insert(ParseItemCount());
-      SkipWhitespace();
-      if (ConsumePrefix("->")) break;
-      if (!ConsumePrefix("+")) Die("expected '+' or '->'");
-      SkipWhitespace();
-    }
-    SkipWhitespace();
-    // Parse the outputs.
-    while (true) {
-      result.outputs.insert(ParseItemCount());
-      SkipWhitespace();
-      if (ConsumePrefix("(")) break;
-      if (!ConsumePrefix("+")) Die("expected '+' or '('");
-      SkipWhitespace();
-    }
-    result.duration = ParseRational();
-    SkipWhitespace();
-    if (!ConsumePrefix("s/run,")) Die("expected '(<N> s/run, cost <N>)'");
-    SkipWhitespace();
-    if (!ConsumePrefix("cost")) Die("expected '(<N> s/run, cost <N>)'");
-    SkipWhitespace();
-    result.cost = ParseRational();
-    if (!ConsumePrefix(")")) Die("expected ')'");
-    return result;
-  }
-
-  Demand ParseDemand() {
-    if (remaining_.empty()) Die("expected demand");
-    const std::string_view resource_name =
-        Sequence<IsIdentifier>("expected a resource name");
-    SkipWhitespace();
-    if (!ConsumePrefix("(")) Die("expected '('");
-    const Rational units_per_minute = ParseRational();
-    SkipWhitespace();
-    if (!ConsumePrefix("units/min)")) Die("expected '(<N> units/min)'");
-    return Demand(resource_name, units_per_minute);
-  }
+#include "trace.hpp"
 
-  Input ParseInput() {
-    Input input;
-    SkipWhitespaceAndComments();
-    while (!remaining_.empty()) {
-      const char lookahead = remaining_.front();
-      if (IsAlpha(lookahead)) {
-        input.demands.push_back(ParseDemand());
-      } else {
-        input.recipes.push_back(ParseRecipe());
-      }
-      SkipWhitespaceAndComments();
-    }
-    return input;
-  }
-
- private:
-  [[noreturn]] void Die(std::string_view message) const {
-    std::cerr << "source:" << line_ << ":" << column_ << ": error: " << message
-              << '\n';
-    std::exit(1);
-  }
-
-  void Advance(int n) {
-    for (char c : remaining_.substr(0, n)) {
-      if (c == '\n') {
-        line_++;
-        column_ = 1;
-      } else {
-        column_++;
-      }
-    }
-    remaining_.remove_prefix(n);
-  }
-
-  void SkipWhitespace() {
-    const char* const first = remaining_.data();
-    const char* const last = first + remaining_.size();
-    const char* i = first;
-    while (i != last && IsWhitespace(*i)) ++i;
-    Advance(i - first);
-  }
-
-  template <auto Predicate>
-  std::string_view PeekSequence() const noexcept {
-    const char* const first = remaining_.data();
-    const char* const end = first + remaining_.size();
-    const char* i = first;
-    while (i != end && Predicate(*i)) i++;
-    return std::string_view(first, i - first);
-  }
+namespace satisfactory {
 
-  template <auto Predicate>
-  std::string_view Sequence(std::string_view expectation) {
-    std::string_view value = PeekSequence<Predicate>();
-    if (value.empty()) Die(expectation);
-    Advance(value.size());
-    return value;
+void Parser::Die(std::string_view message) {
+  if (!failed_) {
+    failed_ = true;
+    error_message_ = message;
+    error_line_ = line_;
+    error_column_ = column_;
   }
+  remaining_ = {};
+}
 
-  bool ConsumePrefix(std::string_view prefix) {
-    if (!remaining_.starts_with(prefix)) return false;
-    Advance(prefix.size());
-    return true;
-  }
+std::string Parser::error() const {
+  if (!failed_) return {};
+  return std::string(filename_) + ":" + std::to_string(error_line_) + ":" +
+         std::to_string(error_column_) +
+         ": error: " + std::string(error_message_);
+}
 
-  void SkipWhitespaceAndComments() {
-    while (true) {
-      SkipWhitespace();
-      if (!remaining_.starts_with("//")) return;
-      const char* const first = remaining_.data();
-      const char* i = first;
-      // This is guaranteed to terminate safely: a Source() always has
-      // a newline character at the end.
-      while (*i != '\n') i++;
-      Advance(i - first);
-    }
+std::optional<Input> ParseInput(std::string_view source,
+                                std::string_view filename, std::string* error) {
+  const TraceSpan span("ParseInput");
+  Parser parser(source, filename);
+  Input input = parser.ParseInput();
+  if (parser.failed()) {
+    if (error) *error = parser.error();
+    return std::nullopt;
   }
+  return input;
+}
 
-  std::string_view remaining_;
-  int line_ = 1;
-  int column_ = 1;
-};
-
-}  // namespace
-
-Input ParseInput(std::string_view source) {
-  return Parser(source).ParseInput();
+std::optional<Rational> ParseRational(std::string_view text) {
+  // Each integer must fit comfortably into the int64_t used by ParseInt.
+  const auto is_integer = [](std::string_view digits) {
+    return !digits.empty() && digits.size() <= 18 &&
+           std::ranges::all_of(digits, [](char c) {
+             return '0' <= c && c <= '9';
+           });
+  };
+  const std::size_t split = text.find_first_of("./");
+  if (!is_integer(text.substr(0, split))) return std::nullopt;
+  if (split != text.npos) {
+    const std::string_view rest = text.substr(split + 1);
+    if (!is_integer(rest)) return std::nullopt;
+    if (text[split] == '/' && rest.find_first_not_of('0') == rest.npos) {
+      return std::nullopt;
+    }
+  }
+  // The text is known to be well-formed, so the parser cannot fail.
+  const std::string line = std::string(text) + '\n';
+  return Parser(line, "").ParseRational();
 }
 
 }  // namespace satisfactory
@@ -1,13 +1,326 @@
 #ifndef PARSER_HPP_
 #define PARSER_HPP_
 
+#include <map>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "data.hpp"
 
 namespace satisfactory {
 
-Input ParseInput(std::string_view source);
+// A recipe whose items are kept in the order that they are written. Unlike
+// Recipe, it can be constructed in a constant expression.
+struct FlatRecipe {
+  std::vector<std::pair<std::string_view, Rational>> inputs, outputs;
+  Rational duration;
+  Rational cost;
+  std::optional<Rational> limit;
+};
+
+// An input file parsed into FlatRecipes, with the members of Input.
+struct FlatInput {
+  std::vector<std::string_view> imports;
+  std::vector<FlatRecipe> recipes;
+  std::vector<Demand> demands;
+  std::vector<Scenario> scenarios;
+  std::vector<Demand> limits;
+};
+
+// A recursive descent parser for input files. It is defined here so that input
+// files can be parsed in constant expressions, where a malformed file is
+// a compile error. Otherwise, parsing stops at the first error, which is then
+// reported by error() against the filename, and the result is incomplete.
+class Parser {
+ public:
+  constexpr Parser(std::string_view source, std::string_view filename)
+      : remaining_(source), filename_(filename) {
+    if (remaining_.empty() || remaining_.back() != '\n') {
+      Advance(remaining_.size());
+      Die("input must end with a newline");
+    }
+  }
+
+  // Whether an error has been found, after which the parsed values are
+  // meaningless.
+  constexpr bool failed() const noexcept { return failed_; }
+  // The first error found, as "<filename>:<line>:<column>: error: <message>".
+  std::string error() const;
+
+  constexpr std::int64_t ParseInt() {
+    const std::string_view number = Sequence<IsDigit>("expected an integer");
+    std::int64_t value = 0;
+    for (char c : number) value = 10 * value + (c - '0');
+    return value;
+  }
+
+  constexpr Rational ParseRational() {
+    Rational value = ParseInt();
+    if (ConsumePrefix(".")) {
+      Rational unit = 1;
+      for (char c : Sequence<IsDigit>("expected digits after decimal point")) {
+        unit /= 10;
+        value += (c - '0') * unit;
+      }
+      return value;
+    } else if (ConsumePrefix("/")) {
+      const std::int64_t denominator = ParseInt();
+      if (denominator == 0) {
+        Die("expected a non-zero denominator");
+        return value;
+      }
+      return value / denominator;
+    } else {
+      return value;
+    }
+  }
+
+  constexpr std::pair<std::string_view, Rational> ParseItemCount() {
+    if (ConsumePrefix("(")) {
+      SkipWhitespace();
+      const std::string_view resource_name =
+          Sequence<IsIdentifier>("expected a primitive resource name");
+      SkipWhitespace();
+      if (!ConsumePrefix(")")) Die("expected ')'");
+      return {resource_name, 0};
+    } else {
+      const Rational count = ParseRational();
+      SkipWhitespace();
+      const std::string_view resource_name =
+          Sequence<IsIdentifier>("expected a resource name");
+      return {resource_name, count};
+    }
+  }
+
+  // Parses a Recipe, or a FlatRecipe in a constant expression.
+  template <typename RecipeType = Recipe>
+  constexpr RecipeType ParseRecipe() {
+    if (remaining_.empty()) Die("expected recipe");
+    RecipeType result;
+    // Parse the inputs.
+    while (!failed_) {
+      AddItem(result.inputs, ParseItemCount());
+      SkipWhitespace();
+      if (ConsumePrefix("->")) break;
+      if (!ConsumePrefix("+")) Die("expected '+' or '->'");
+      SkipWhitespace();
+    }
+    SkipWhitespace();
+    // Parse the outputs.
+    while (!failed_) {
+      AddItem(result.outputs, ParseItemCount());
+      SkipWhitespace();
+      if (ConsumePrefix("(")) break;
+      if (!ConsumePrefix("+")) Die("expected '+' or '('");
+      SkipWhitespace();
+    }
+    result.duration = ParseRational();
+    if (result.duration == 0) Die("expected a non-zero duration");
+    SkipWhitespace();
+    if (!ConsumePrefix("s/run,")) Die("expected '(<N> s/run, cost <N>)'");
+    SkipWhitespace();
+    if (!ConsumePrefix("cost")) Die("expected '(<N> s/run, cost <N>)'");
+    SkipWhitespace();
+    result.cost = ParseRational();
+    // An optional limit on the use of the recipe.
+    if (ConsumePrefix(",")) {
+      SkipWhitespace();
+      if (!ConsumePrefix("max")) Die("expected 'max <N>'");
+      SkipWhitespace();
+      result.limit = ParseRational();
+    }
+    if (!ConsumePrefix(")")) Die("expected ')'");
+    return result;
+  }
+
+  constexpr Demand ParseDemand() {
+    if (remaining_.empty()) Die("expected demand");
+    const std::string_view resource_name =
+        Sequence<IsIdentifier>("expected a resource name");
+    SkipWhitespace();
+    if (!ConsumePrefix("(")) Die("expected '('");
+    const Rational units_per_minute = ParseRational();
+    SkipWhitespace();
+    if (!ConsumePrefix("units/min)")) Die("expected '(<N> units/min)'");
+    return Demand(resource_name, units_per_minute);
+  }
+
+  constexpr std::string_view ParseScenarioHeader() {
+    if (!ConsumePrefix("[")) Die("expected '['");
+    std::string_view name =
+        Sequence<IsScenarioName>("expected a scenario name");
+    if (!ConsumePrefix("]")) Die("expected ']'");
+    while (!name.empty() && IsWhitespace(name.front())) name.remove_prefix(1);
+    while (!name.empty() && IsWhitespace(name.back())) name.remove_suffix(1);
+    if (name.empty()) Die("expected a scenario name");
+    return name;
+  }
+
+  constexpr Demand ParseLimit() {
+    if (!ConsumePrefix("limit")) Die("expected 'limit'");
+    SkipWhitespace();
+    return ParseDemand();
+  }
+
+  constexpr std::string_view ParseImport() {
+    if (!ConsumePrefix("import")) Die("expected 'import'");
+    SkipWhitespace();
+    if (!ConsumePrefix("\"")) Die("expected '\"'");
+    const std::string_view path = Sequence<IsPathCharacter>("expected a path");
+    if (!ConsumePrefix("\"")) Die("expected '\"'");
+    return path;
+  }
+
+  // Parses an Input, or a FlatInput in a constant expression.
+  template <typename InputType = Input>
+  constexpr InputType ParseInput() {
+    using RecipeType = typename decltype(InputType::recipes)::value_type;
+    InputType input;
+    SkipWhitespaceAndComments();
+    while (!remaining_.empty()) {
+      const char lookahead = remaining_.front();
+      if (lookahead == '[') {
+        // Demands which precede the first scenario would otherwise be silently
+        // ignored whenever scenarios are present.
+        if (!input.demands.empty()) {
+          Die("scenarios cannot be mixed with top-level demands");
+        }
+        input.scenarios.push_back(
+            Scenario{.name = ParseScenarioHeader(), .demands = {}});
+      } else if (PeekSequence<IsIdentifier>() == "import") {
+        input.imports.push_back(ParseImport());
+      } else if (PeekSequence<IsIdentifier>() == "limit") {
+        // Limits apply to every scenario, so they cannot appear in one.
+        if (!input.scenarios.empty()) Die("limits must precede all scenarios");
+        input.limits.push_back(ParseLimit());
+      } else if (IsAlpha(lookahead)) {
+        std::vector<Demand>& demands = input.scenarios.empty()
+                                           ? input.demands
+                                           : input.scenarios.back().demands;
+        demands.push_back(ParseDemand());
+      } else {
+        input.recipes.push_back(ParseRecipe<RecipeType>());
+      }
+      SkipWhitespaceAndComments();
+    }
+    return input;
+  }
+
+ private:
+  static constexpr bool IsWhitespace(char c) {
+    return c == ' ' || c == '\r' || c == '\n';
+  }
+  static constexpr bool IsLower(char c) { return 'a' <= c && c <= 'z'; }
+  static constexpr bool IsUpper(char c) { return 'A' <= c && c <= 'Z'; }
+  static constexpr bool IsAlpha(char c) { return IsLower(c) || IsUpper(c); }
+  static constexpr bool IsDigit(char c) { return '0' <= c && c <= '9'; }
+  static constexpr bool IsIdentifier(char c) {
+    return IsAlpha(c) || IsDigit(c);
+  }
+  static constexpr bool IsScenarioName(char c) { return c != ']' && c != '\n'; }
+  static constexpr bool IsPathCharacter(char c) {
+    return c != '"' && c != '\n';
+  }
+
+  // A resource which is listed twice keeps its first count.
+  static void AddItem(std::map<std::string_view, Rational>& items,
+                      const std::pair<std::string_view, Rational>& item) {
+    items.insert(item);
+  }
+  static constexpr void AddItem(
+      std::vector<std::pair<std::string_view, Rational>>& items,
+      const std::pair<std::string_view, Rational>& item) {
+    for (const auto& [name, count] : items) {
+      if (name == item.first) return;
+    }
+    items.push_back(item);
+  }
+
+  // Records an error at the current position, unless one was found earlier, and
+  // skips the rest of the source so that parsing stops. Since this cannot be
+  // evaluated at compile time, an error in a constant expression fails the
+  // build.
+  void Die(std::string_view message);
+
+  constexpr void Advance(int n) {
+    for (char c : remaining_.substr(0, n)) {
+      if (c == '\n') {
+        line_++;
+        column_ = 1;
+      } else {
+        column_++;
+      }
+    }
+    remaining_.remove_prefix(n);
+  }
+
+  constexpr void SkipWhitespace() {
+    const char* const first = remaining_.data();
+    const char* const last = first + remaining_.size();
+    const char* i = first;
+    while (i != last && IsWhitespace(*i)) ++i;
+    Advance(i - first);
+  }
+
+  template <auto Predicate>
+  constexpr std::string_view PeekSequence() const noexcept {
+    const char* const first = remaining_.data();
+    const char* const end = first + remaining_.size();
+    const char* i = first;
+    while (i != end && Predicate(*i)) i++;
+    return std::string_view(first, i - first);
+  }
+
+  template <auto Predicate>
+  constexpr std::string_view Sequence(std::string_view expectation) {
+    std::string_view value = PeekSequence<Predicate>();
+    if (value.empty()) Die(expectation);
+    Advance(value.size());
+    return value;
+  }
+
+  constexpr bool ConsumePrefix(std::string_view prefix) {
+    if (!remaining_.starts_with(prefix)) return false;
+    Advance(prefix.size());
+    return true;
+  }
+
+  constexpr void SkipWhitespaceAndComments() {
+    while (true) {
+      SkipWhitespace();
+      if (!remaining_.starts_with("//")) return;
+      const char* const first = remaining_.data();
+      const char* i = first;
+      // This is guaranteed to terminate safely: a Source() always has
+      // a newline character at the end.
+      while (*i != '\n') i++;
+      Advance(i - first);
+    }
+  }
+
+  std::string_view remaining_;
+  std::string_view filename_;
+  int line_ = 1;
+  int column_ = 1;
+  // The first error, if any.
+  bool failed_ = false;
+  std::string_view error_message_;
+  int error_line_ = 0;
+  int error_column_ = 0;
+};
+
+// Parses an input file. If it is malformed, returns std::nullopt and sets
+// error, if non-null, to the first error, reported against the filename.
+std::optional<Input> ParseInput(std::string_view source,
+                                std::string_view filename = "source",
+                                std::string* error = nullptr);
+
+// Parses a quantity written as in an input file, such as "3", "2.5" or "1/5".
+// Unlike ParseInput, malformed text is not fatal: it yields std::nullopt.
+std::optional<Rational> ParseRational(std::string_view text);
 
 }  // namespace satisfactory
 
@@ -70,27 +70,27 @@ class Rational {
     return l.numerator_ * r.denominator_ <=> r.numerator_ * l.denominator_;
   }
 
-  Rational& operator+=(const Rational& other) {
+  constexpr Rational& operator+=(const Rational& other) {
     return (*this = *this + other);
   }
 
-  Rational& operator-=(const Rational& other) {
+  constexpr Rational& operator-=(const Rational& other) {
     return (*this = *this - other);
   }
 
-  Rational& operator*=(const Rational& other) {
+  constexpr Rational& operator*=(const Rational& other) {
     return (*this = *this * other);
   }
 
-  Rational& operator/=(const Rational& other) {
+  constexpr Rational& operator/=(const Rational& other) {
     return (*this = *this / other);
   }
 
-  int128 numerator() const noexcept { return numerator_; }
-  int128 denominator() const noexcept { return denominator_; }
+  constexpr int128 numerator() const noexcept { return numerator_; }
+  constexpr int128 denominator() const noexcept { return denominator_; }
 
  private:
-  void Normalize() {
+  constexpr void Normalize() {
     const int128 x = gcd(numerator_, denominator_);
     numerator_ /= x;
     denominator_ /= x;
@@ -0,0 +1,118 @@
+#include "serialize.hpp"
+
+#include <fstream>
+#include <random>
+
+namespace satisfactory {
+
+void Writer::WriteU8(std::uint8_t value) { buffer_.push_back(char(value)); }
+
+void Writer::WriteU32(std::uint32_t value) {
+  for (int i = 0; i < 4; i++) buffer_.push_back(char(value >> (8 * i)));
+}
+
+void Writer::WriteU64(std::uint64_t value) {
+  for (int i = 0; i < 8; i++) buffer_.push_back(char(value >> (8 * i)));
+}
+
+void Writer::WriteInt128(const int128& value) {
+  // Most values are small, so only the significant words are stored.
+  const std::span<const std::uint32_t> words = value.magnitude().words();
+  const int size = integer::RealSize(words);
+  WriteU8(std::uint8_t(size << 1 | (value.negative() && size ? 1 : 0)));
+  for (int i = 0; i < size; i++) WriteU32(words[i]);
+}
+
+void Writer::WriteRational(const Rational& value) {
+  WriteInt128(value.numerator());
+  WriteInt128(value.denominator());
+}
+
+void Writer::WriteString(std::string_view value) {
+  WriteU32(value.size());
+  buffer_.append(value);
+}
+
+bool Reader::Take(std::size_t n, std::string_view& bytes) noexcept {
+  if (!ok_ || remaining_.size() < n) {
+    ok_ = false;
+    return false;
+  }
+  bytes = remaining_.substr(0, n);
+  remaining_.remove_prefix(n);
+  return true;
+}
+
+std::uint8_t Reader::ReadU8() noexcept {
+  std::string_view bytes;
+  if (!Take(1, bytes)) return 0;
+  return bytes[0];
+}
+
+std::uint32_t Reader::ReadU32() noexcept {
+  std::string_view bytes;
+  if (!Take(4, bytes)) return 0;
+  std::uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    value |= std::uint32_t(std::uint8_t(bytes[i])) << (8 * i);
+  }
+  return value;
+}
+
+std::uint64_t Reader::ReadU64() noexcept {
+  const std::uint64_t low = ReadU32();
+  const std::uint64_t high = ReadU32();
+  return high << 32 | low;
+}
+
+int128 Reader::ReadInt128() noexcept {
+  const std::uint8_t header = ReadU8();
+  const int size = header >> 1;
+  uint128 magnitude;
+  const std::span<std::uint32_t> words = magnitude.words();
+  if (size > int(words.size())) {
+    ok_ = false;
+    return 0;
+  }
+  for (int i = 0; i < size; i++) words[i] = ReadU32();
+  return header & 1 ? -int128(magnitude) : int128(magnitude);
+}
+
+Rational Reader::ReadRational() noexcept {
+  const int128 numerator = ReadInt128();
+  const int128 denominator = ReadInt128();
+  if (denominator <= 0) {
+    ok_ = false;
+    return 0;
+  }
+  return Rational(numerator, denominator);
+}
+
+std::string_view Reader::ReadString() noexcept {
+  const std::uint32_t size = ReadU32();
+  std::string_view bytes;
+  if (!Take(size, bytes)) return {};
+  return bytes;
+}
+
+bool WriteFileAtomically(const std::filesystem::path& path,
+                         std::string_view data) {
+  std::error_code error;
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path(), error);
+    if (error) return false;
+  }
+  std::filesystem::path temp = path;
+  temp += ".tmp" + std::to_string(std::random_device()());
+  {
+    std::ofstream file(temp, std::ios::binary);
+    file.write(data.data(), data.size());
+    if (!file.good()) error = std::make_error_code(std::errc::io_error);
+  }
+  if (!error) std::filesystem::rename(temp, path, error);
+  if (!error) return true;
+  std::filesystem::remove(temp, error);
+  return false;
+}
+
+}  // namespace satisfactory
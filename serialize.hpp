@@ -0,0 +1,67 @@
+#ifndef SERIALIZE_HPP_
+#define SERIALIZE_HPP_
+
+#include "rational.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace satisfactory {
+
+// Appends a compact little-endian binary encoding of values to a buffer.
+class Writer {
+ public:
+  void WriteU8(std::uint8_t value);
+  void WriteU32(std::uint32_t value);
+  void WriteU64(std::uint64_t value);
+  void WriteInt128(const int128& value);
+  void WriteRational(const Rational& value);
+  // Writes a length-prefixed string.
+  void WriteString(std::string_view value);
+
+  const std::string& buffer() const noexcept { return buffer_; }
+  std::string& buffer() noexcept { return buffer_; }
+
+ private:
+  std::string buffer_;
+};
+
+// Decodes values written by a Writer. Reading past the end of the data or
+// decoding a malformed value puts the reader into a failed state, after which
+// every read returns a default value. Callers check ok() once at the end.
+class Reader {
+ public:
+  explicit Reader(std::string_view data) noexcept : remaining_(data) {}
+
+  std::uint8_t ReadU8() noexcept;
+  std::uint32_t ReadU32() noexcept;
+  std::uint64_t ReadU64() noexcept;
+  int128 ReadInt128() noexcept;
+  Rational ReadRational() noexcept;
+  // The returned view refers to the underlying data.
+  std::string_view ReadString() noexcept;
+
+  bool ok() const noexcept { return ok_; }
+  bool empty() const noexcept { return remaining_.empty(); }
+  // The number of bytes which have not been read yet.
+  std::size_t size() const noexcept { return remaining_.size(); }
+
+ private:
+  bool Take(std::size_t n, std::string_view& bytes) noexcept;
+
+  std::string_view remaining_;
+  bool ok_ = true;
+};
+
+// Replaces the contents of a file, creating its directory if necessary. The
+// data is written to a temporary file which is then renamed into place, so
+// that concurrent readers never observe a partially written file. Returns false
+// if the file could not be written.
+bool WriteFileAtomically(const std::filesystem::path& path,
+                         std::string_view data);
+
+}  // namespace satisfactory
+
+#endif  // SERIALIZE_HPP_
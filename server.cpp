@@ -0,0 +1,247 @@
+#include "server.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "parser.hpp"
+#include "solver.hpp"
+#include "trace.hpp"
+
+namespace satisfactory {
+namespace {
+
+bool WriteAll(int fd, std::string_view data) {
+  while (!data.empty()) {
+    // Sockets are written with MSG_NOSIGNAL so that a client which hangs up
+    // early does not kill the server with SIGPIPE.
+    ssize_t n = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+    if (n < 0 && errno == ENOTSOCK) n = write(fd, data.data(), data.size());
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    data.remove_prefix(n);
+  }
+  return true;
+}
+
+// Calls f with each complete line read from the file descriptor, excluding
+// the line terminator. A final unterminated line is also passed to f.
+template <typename F>
+void ForEachLine(int fd, F f) {
+  std::string buffer;
+  char chunk[4096];
+  while (true) {
+    const ssize_t n = read(fd, chunk, sizeof(chunk));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    buffer.append(chunk, n);
+    std::size_t start = 0;
+    while (true) {
+      const std::size_t end = buffer.find('\n', start);
+      if (end == buffer.npos) break;
+      f(std::string_view(buffer).substr(start, end - start));
+      start = end + 1;
+    }
+    buffer.erase(0, start);
+  }
+  if (!buffer.empty()) f(buffer);
+}
+
+std::vector<std::string_view> Split(std::string_view line) {
+  std::vector<std::string_view> words;
+  while (true) {
+    const std::size_t start = line.find_first_not_of(" \t\r");
+    if (start == line.npos) return words;
+    line.remove_prefix(start);
+    const std::size_t end = std::min(line.find_first_of(" \t\r"), line.size());
+    words.push_back(line.substr(0, end));
+    line.remove_prefix(end);
+  }
+}
+
+// Tracks the responses which are still outstanding for one stream of
+// requests, and serializes writes of those responses.
+class Connection {
+ public:
+  explicit Connection(int fd) : fd_(fd) {}
+
+  void Begin() {
+    std::unique_lock lock(mutex_);
+    pending_++;
+  }
+
+  void Finish(std::string_view response) {
+    std::unique_lock lock(mutex_);
+    WriteAll(fd_, response);
+    if (--pending_ == 0) done_.notify_all();
+  }
+
+  void Wait() {
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [&] { return pending_ == 0; });
+  }
+
+ private:
+  const int fd_;
+  std::mutex mutex_;
+  std::condition_variable done_;
+  int pending_ = 0;
+};
+
+}  // namespace
+
+Server::Server(ModuleCache& modules, const SolveOptions& options,
+               Numbers numbers, int num_threads)
+    : modules_(modules),
+      options_(options),
+      numbers_(numbers),
+      pool_(num_threads) {}
+
+void Server::Serve(int input_fd, int output_fd) {
+  Connection connection(output_fd);
+  ForEachLine(input_fd, [&](std::string_view line) {
+    if (line.find_first_not_of(" \t\r") == line.npos) return;
+    connection.Begin();
+    pool_.Post([this, &connection, request = std::string(line)] {
+      connection.Finish(Handle(request));
+    });
+  });
+  connection.Wait();
+}
+
+void Server::ServeUnixSocket(const std::string& path) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Socket path is too long: " << path << '\n';
+    return;
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(path.c_str());
+  if (listener < 0 ||
+      bind(listener, reinterpret_cast<const sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(listener, SOMAXCONN) != 0) {
+    std::cerr << "Failed to listen on " << path << ": " << std::strerror(errno)
+              << '\n';
+    if (listener >= 0) close(listener);
+    return;
+  }
+  while (true) {
+    const int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      std::cerr << "accept: " << std::strerror(errno) << '\n';
+      close(listener);
+      return;
+    }
+    // Each connection gets a thread for reading requests, while the solves
+    // themselves share the pool.
+    std::thread([this, fd] {
+      Serve(fd, fd);
+      close(fd);
+    }).detach();
+  }
+}
+
+std::string Server::Handle(std::string_view request) {
+  const TraceSpan span("Handle");
+  const std::vector<std::string_view> words = Split(request);
+  const std::string_view id = words.empty() ? "-" : words[0];
+  // The buffer is reused across the requests handled by each pool thread.
+  thread_local OutputBuffer response;
+  response.Clear();
+  const auto error = [&](std::string_view message,
+                         std::string_view detail = {}) {
+    response.Append("{\"id\":");
+    response.AppendJsonString(id);
+    response.Append(",\"status\":\"error\",\"error\":");
+    response.AppendJsonString(std::string(message) + std::string(detail));
+    response.Append("}\n");
+    return std::string(response.view());
+  };
+  if (words.empty()) return error("empty request");
+  if (words.size() < 2 || words.size() % 2 != 0) {
+    return error("expected <id> <database> [<resource> <units/min>]...");
+  }
+  const std::filesystem::path database(words[1]);
+  std::error_code error_code;
+  if (!std::filesystem::is_regular_file(database, error_code)) {
+    return error("no such database: ", words[1]);
+  }
+  std::vector<Demand> demands;
+  for (std::size_t i = 2; i < words.size(); i += 2) {
+    const std::optional<Rational> rate = ParseRational(words[i + 1]);
+    if (!rate) return error("invalid rate: ", words[i + 1]);
+    demands.push_back(Demand(words[i], *rate));
+  }
+  std::string message;
+  const Input* const input = modules_.Load(database, &message);
+  if (!input) return error(message);
+  const std::filesystem::path key = std::filesystem::weakly_canonical(database);
+  Basis warm_start, final_basis;
+  {
+    std::unique_lock lock(bases_mutex_);
+    if (auto i = bases_.find(key); i != bases_.end()) warm_start = i->second;
+  }
+  SolveOptions options = options_;
+  options.warm_start = &warm_start;
+  options.final_basis = &final_basis;
+  options.error = &message;
+  const std::optional<Solution> solution = Solve(*input, demands, options);
+  if (solution && !(final_basis.resources.empty() &&
+                   final_basis.recipes.empty())) {
+    std::unique_lock lock(bases_mutex_);
+    bases_[key] = std::move(final_basis);
+  }
+  if (!solution) {
+    return error("a solution could not be found",
+                 message.empty() ? "" : ": " + message);
+  }
+  const Tag tags[] = {{"id", id}, {"status", "ok"}};
+  WriteJsonLine(response, *solution, tags, numbers_);
+  return std::string(response.view());
+}
+
+bool RunClient(const std::string& path, int input_fd, int output_fd) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) return false;
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address),
+                        sizeof(address)) != 0) {
+    std::cerr << "Failed to connect to " << path << ": "
+              << std::strerror(errno) << '\n';
+    if (fd >= 0) close(fd);
+    return false;
+  }
+  std::thread responses([&] {
+    ForEachLine(fd, [&](std::string_view line) {
+      WriteAll(output_fd, line);
+      WriteAll(output_fd, "\n");
+    });
+  });
+  ForEachLine(input_fd, [&](std::string_view line) {
+    WriteAll(fd, line);
+    WriteAll(fd, "\n");
+  });
+  // Half-close the connection so that the server knows there are no more
+  // requests, then wait for the remaining responses.
+  shutdown(fd, SHUT_WR);
+  responses.join();
+  close(fd);
+  return true;
+}
+
+}  // namespace satisfactory
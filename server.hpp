@@ -0,0 +1,67 @@
+#ifndef SERVER_HPP_
+#define SERVER_HPP_
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "basis.hpp"
+#include "module.hpp"
+#include "output.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
+
+namespace satisfactory {
+
+// A resident solve server. Recipe databases are loaded through a module cache
+// on first use and stay resident for the lifetime of the server, as does the
+// most recent optimal basis for each database, which is used to warm start the
+// next request for that database.
+//
+// Requests and responses are single lines. A request has the form:
+//
+//   <id> <database> <resource> <units/min> [<resource> <units/min>]...
+//
+// where <database> is the path of an input file whose recipes should be used,
+// and quantities use the same syntax as input files (e.g. "3", "2.5", "1/5").
+// Requests are solved concurrently, so responses may be written in a different
+// order than the requests were received. Each response is a JSON object on
+// a single line (see WriteJsonLine) whose "id" field is the id of its request.
+// Failed requests produce an object with an "error" field instead of
+// a solution.
+class Server {
+ public:
+  Server(ModuleCache& modules, const SolveOptions& options = {},
+         Numbers numbers = Numbers::kExact, int num_threads = 0);
+
+  // Serves requests read from input_fd and writes responses to output_fd until
+  // the input is exhausted and every response has been written.
+  void Serve(int input_fd, int output_fd);
+
+  // Listens on a Unix domain socket at the given path and serves each
+  // connection as above. This function does not return unless the socket
+  // cannot be created.
+  void ServeUnixSocket(const std::string& path);
+
+  // Handles a single request line and returns the response line, including
+  // the trailing newline.
+  std::string Handle(std::string_view request);
+
+ private:
+  ModuleCache& modules_;
+  const SolveOptions options_;
+  const Numbers numbers_;
+  std::mutex bases_mutex_;
+  std::map<std::filesystem::path, Basis> bases_;
+  ThreadPool pool_;
+};
+
+// Connects to a server listening on a Unix domain socket, sends every line of
+// input_fd to it and copies the responses to output_fd.
+bool RunClient(const std::string& path, int input_fd, int output_fd);
+
+}  // namespace satisfactory
+
+#endif  // SERVER_HPP_
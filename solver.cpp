@@ -42,7 +42,9 @@
 //     us the fractional number of instances for each recipe that we should use.
 //     Note that we will need to build at least ceil(x_i) machines for recipe i
 //     in practice, since we can't have fractional machines, but we can
-//     underclock those machines to achieve optimal efficiency.
+//     underclock those machines to achieve optimal efficiency. Alternatively,
+//     x can be restricted to whole multiples of a granularity by branch and
+//     bound, with each branch adding a bound as described below.
 //   * d is our column vector of demands, with one row per resource type. This
 //     will be 0 for all other resource types (to ensure that our resulting
 //     factory does not rely on externally provided resources). Note that raw
@@ -78,19 +80,76 @@
 // Given r recipes across n resource types, this table will have r + 1 rows and
 // n + r + 2 columns. I is an r x r identity matrix representing the variables
 // in x, which serve as the slack variables for the dual problem.
+//
+// Recipes may be limited in how much they are used, and resources in how much
+// of them is produced. Each such bound is a constraint dot(b, x) <= u on the
+// primal problem, which adds a variable w >= 0 to the dual problem:
+//
+// maximize dot(d, y) - u * w
+// subject to:
+//
+//   R^T y - b * w + x = c
+//
+// The column of w is a weighted sum of the slack columns, and it stays that way
+// as the tableau is pivoted, so it is never stored. Instead, it is computed
+// from the slack columns when it is needed, as in a bounded-variable simplex,
+// and bounds cost almost nothing until they are violated.
+//
+// Problems with many recipes need many pivots on a huge tableau, so they are
+// solved approximately by the interior-point method first, and the simplex
+// algorithm only confirms and corrects the basis which that identifies.
+//
+// Since d only appears in the cost row, an optimal tableau stays optimal as d
+// changes until an entry of the cost row falls to zero. Sweeping the demands
+// along a direction therefore only needs to move the cost row and pivot at
+// those points, which are the breakpoints of the cost.
 
 #include "solver.hpp"
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <numeric>
 #include <optional>
 #include <set>
+#include <string>
 
+#include "basis.hpp"
+#include "cache.hpp"
+#include "certificate.hpp"
+#include "decompose.hpp"
+#include "interior.hpp"
+#include "modular.hpp"
+#include "network.hpp"
+#include "stats.hpp"
 #include "table.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 
 namespace satisfactory {
 namespace {
 
+// Only one in this many pivots is traced, which keeps traces of large problems
+// small while still showing how the cost of a pivot changes over a solve.
+constexpr int kTracedPivotInterval = 16;
+
+// Progress is reported once every this many pivots.
+constexpr int kProgressInterval = 16;
+
+// Blocks with at least this many recipes are solved by the interior-point
+// method, unless another engine is chosen. Below it, the simplex algorithm on
+// its own takes well under a second, and keeps giving the solutions that it
+// always has when several are optimal.
+constexpr int kInteriorPointRecipes = 500;
+
+// A reduced cost from the interior-point method below this fraction of the cost
+// of the recipe is taken to be zero, well above its accuracy but well below any
+// meaningful reduced cost.
+constexpr double kNoReducedCost = 1e-6;
+
 // Multiplies each element in the row by x.
 constexpr void Multiply(std::span<Rational> row, Rational x) noexcept {
   for (Rational& d : row) d *= x;
@@ -111,76 +170,154 @@ constexpr void AddMultiple(std::span<Rational> destination,
   }
 }
 
-// Retrieves a sorted list of all resources referenced by recipes or demands.
-std::vector<std::string_view> Resources(const Input& input) {
-  std::vector<std::string_view> result;
-  for (const auto& recipe : input.recipes) {
-    for (const auto& [resource, quantity] : recipe.inputs) {
-      result.push_back(resource);
-    }
-    for (const auto& [resource, quantity] : recipe.outputs) {
-      result.push_back(resource);
-    }
+// Returns the tableau column of a resource, given the sorted list of resources.
+int ResourceColumn(std::span<const std::string_view> resources,
+                   std::string_view name) {
+  const auto first = resources.begin();
+  const auto last = resources.end();
+  const auto i = std::lower_bound(first, last, name);
+  assert(i != last && *i == name);
+  return i - first;
+}
+
+// Populates the rates and the cost of a recipe in its row of the tableau.
+void SetRecipeRow(std::span<Rational> row,
+                  std::span<const std::string_view> resources,
+                  const Recipe& recipe) {
+  // A resource can be both an input and an output of the same recipe, in which
+  // case only the difference matters.
+  for (const auto& [resource, quantity] : recipe.inputs) {
+    row[ResourceColumn(resources, resource)] -=
+        Rational(quantity) / recipe.duration;
   }
-  for (const auto& [name, rate] : input.demands) {
-    result.push_back(name);
+  for (const auto& [resource, quantity] : recipe.outputs) {
+    row[ResourceColumn(resources, resource)] +=
+        Rational(quantity) / recipe.duration;
   }
-  std::ranges::sort(result);
-  auto [first, last] = std::ranges::unique(result);
-  result.erase(first, last);
-  result.shrink_to_fit();
-  return result;
+  row.back() = recipe.cost;
 }
 
 // Given a sorted list of resource types and an input problem, build the initial
-// Simplex tableau for the dual problem.
+// Simplex tableau for the dual problem, allocated from the pool if it is
+// non-null.
 Table<Rational> BuildTableau(std::span<const std::string_view> resources,
-                             const Input& input) {
+                             const Input& input,
+                             std::span<const Demand> demands,
+                             TablePool* pool = nullptr) {
   const int r = input.recipes.size();
   const int n = resources.size();
-  const auto column = [&](std::string_view name) -> int {
-    const auto first = resources.begin();
-    const auto last = resources.end();
-    const auto i = std::lower_bound(first, last, name);
-    assert(i != last && *i == name);
-    return i - first;
-  };
-  Table<Rational> tableau(n + r + 2, r + 1);
+  Table<Rational> tableau(n + r + 2, r + 1, pool);
   for (int y = 0; y < r; y++) {
-    const Recipe& recipe = input.recipes[y];
-    auto row = tableau[y];
-    // Populate the recipe rates.
-    for (const auto& [resource, quantity] : recipe.inputs) {
-      row[column(resource)] = -Rational(quantity) / recipe.duration;
-    }
-    for (const auto& [resource, quantity] : recipe.outputs) {
-      row[column(resource)] = Rational(quantity) / recipe.duration;
-    }
-    // Populate the cost.
-    row.back() = recipe.cost;
+    SetRecipeRow(tableau[y], resources, input.recipes[y]);
     // Populate the appropriate slack variable.
-    row[n + y] = 1;
+    tableau[y][n + y] = 1;
   }
   // Populate the final row of the table.
   const auto final_row = tableau[r];
-  for (const auto& demand : input.demands) {
-    final_row[column(demand.name)] = -Rational(demand.units_per_minute) / 60;
+  for (const auto& demand : demands) {
+    final_row[ResourceColumn(resources, demand.name)] -=
+        Rational(demand.units_per_minute) / 60;
   }
   final_row[n + r] = 1;
   return tableau;
 }
 
-std::optional<int> PivotColumn(const Table<Rational>& tableau) {
+// A bound on the primal problem: the sum of weight * x_i over the terms must be
+// at most the limit. In a basis, bound k is given the column -1 - k.
+struct Bound {
+  // Pairs of recipe index and weight.
+  std::vector<std::pair<int, Rational>> terms;
+  Rational limit;
+};
+
+// Returns the bounds on the recipes of the input and on the production of its
+// resources. Production is per second, like the recipe rates in the tableau. If
+// origins is non-null, it receives the origin of each bound: i for the limit of
+// recipe i, or -1 - l for input.limits[l].
+std::vector<Bound> GetBounds(const Input& input,
+                             std::vector<int>* origins = nullptr) {
+  const int r = input.recipes.size();
+  std::vector<Bound> bounds;
+  for (int i = 0; i < r; i++) {
+    if (const std::optional<Rational>& limit = input.recipes[i].limit) {
+      bounds.push_back({.terms = {{i, 1}}, .limit = *limit});
+      if (origins) origins->push_back(i);
+    }
+  }
+  for (int l = 0; l < std::ssize(input.limits); l++) {
+    const auto& [resource, units_per_minute] = input.limits[l];
+    Bound bound{.terms = {}, .limit = units_per_minute / 60};
+    for (int i = 0; i < r; i++) {
+      const Recipe& recipe = input.recipes[i];
+      Rational quantity = 0;
+      if (auto j = recipe.outputs.find(resource); j != recipe.outputs.end()) {
+        quantity += j->second;
+      }
+      if (auto j = recipe.inputs.find(resource); j != recipe.inputs.end()) {
+        quantity -= j->second;
+      }
+      if (quantity > 0) bound.terms.push_back({i, quantity / recipe.duration});
+    }
+    // A limit on a resource which nothing produces is always met.
+    if (bound.terms.empty()) continue;
+    bounds.push_back(std::move(bound));
+    if (origins) origins->push_back(-1 - l);
+  }
+  return bounds;
+}
+
+// Returns the entries of a column of the tableau, including the cost row.
+std::vector<Rational> GetColumn(const Table<Rational>& tableau,
+                                std::span<const Bound> bounds, int column) {
+  const int height = tableau.height();
+  std::vector<Rational> result(height);
+  if (column >= 0) {
+    for (int y = 0; y < height; y++) result[y] = tableau[y][column];
+    return result;
+  }
+  // The column of a bound is minus the weighted sum of the slack columns of its
+  // recipes, except that the limit is added to its cost.
+  const Bound& bound = bounds[-1 - column];
+  const int n = tableau.width() - height - 1;
+  for (const auto& [i, weight] : bound.terms) {
+    for (int y = 0; y < height; y++) {
+      const Rational& x = tableau[y][n + i];
+      if (x != 0) result[y] -= weight * x;
+    }
+  }
+  result[height - 1] += bound.limit;
+  return result;
+}
+
+std::optional<int> PivotColumn(const Table<Rational>& tableau,
+                               std::span<const Bound> bounds) {
   // Find the column with the minimum value in the cost row. This will be the
   // pivot column (assuming that the tableau is not already optimal), as the
   // most negative column is the one which gives the largest improvement in
   // the cost function with respect to change in the corresponding variable.
   const std::span<const Rational> cost_row = tableau[tableau.height() - 1];
-  const auto i = std::ranges::min_element(cost_row);
-  return *i < 0 ? std::optional<int>(i - cost_row.begin()) : std::nullopt;
+  const auto min = std::ranges::min_element(cost_row);
+  int column = min - cost_row.begin();
+  Rational best = *min;
+  // The cost of a bound is its limit less the weighted sum of the recipe uses,
+  // which are in the cost row, so it is negative when the bound is violated.
+  const int n = tableau.width() - tableau.height() - 1;
+  for (int k = 0; k < std::ssize(bounds); k++) {
+    Rational cost = bounds[k].limit;
+    for (const auto& [i, weight] : bounds[k].terms) {
+      cost -= weight * cost_row[n + i];
+    }
+    if (cost < best) {
+      column = -1 - k;
+      best = cost;
+    }
+  }
+  return best < 0 ? std::optional<int>(column) : std::nullopt;
 }
 
-std::optional<int> PivotRow(const Table<Rational>& tableau, int column) {
+// Given the entries of the pivot column, as returned by GetColumn.
+std::optional<int> PivotRow(const Table<Rational>& tableau,
+                            std::span<const Rational> column) {
   // Find the row with the minimum ratio between its constant term and its
   // coefficient in the pivot column. This minimum ratio test ensures that the
   // other basic variables remain positive (and therefore feasible) after the
@@ -191,7 +328,7 @@ std::optional<int> PivotRow(const Table<Rational>& tableau, int column) {
   };
   std::optional<Best> best;
   for (int y = 0; y < tableau.height() - 1; y++) {
-    const Rational coefficient = tableau[y][column];
+    const Rational& coefficient = column[y];
     const Rational value = tableau[y].back();
     // Skip rows which have a non-positive coefficient: the entering variable
     // will have the new value `value / coefficient`, and it is required that
@@ -206,41 +343,340 @@ std::optional<int> PivotRow(const Table<Rational>& tableau, int column) {
   }
   // If no best row has been identified, that would mean that the entering
   // variable is unbounded, and it has a positive contribution towards the score
-  // function, hence there is would be no optimal solution. Since we know that
-  // our primal problem is feasible, this can never happen.
+  // function, hence there is would be no optimal solution. The primal problem
+  // is then infeasible, which can only happen if its bounds are too tight.
   return best ? std::optional<int>(best->row) : std::nullopt;
 }
 
-// Optimize a Simplex tableau.
-std::optional<Table<Rational>> Solve(Table<Rational> tableau) {
-  const std::span<const Rational> cost_row = tableau[tableau.height() - 1];
-  while (true) {
+// Uses Gaussian elimination to turn the column with the given entries into the
+// row'th column of the identity matrix, making the corresponding variable basic
+// in that row.
+void Pivot(Table<Rational>& tableau, int row,
+           std::span<const Rational> column) {
+  Multiply(tableau[row], 1 / column[row]);
+  for (int y = 0; y < tableau.height(); y++) {
+    // The tableau is sparse, so many rows are already zero in this column.
+    if (y == row || column[y] == 0) continue;
+    AddMultiple(tableau[y], tableau[row], -column[y]);
+  }
+}
+
+void Pivot(Table<Rational>& tableau, int row, int column) {
+  Pivot(tableau, row, GetColumn(tableau, {}, column));
+  assert(tableau[row][column] == 1);
+}
+
+// Stops a solve early and reports its progress, as requested by its options.
+// A single monitor is shared by the tableaus of every block of the problem,
+// which may be pivoted on several threads. The lower bound on the cost is the
+// sum of the objectives of the dual problems of the blocks, each of which
+// starts at zero and only rises, until it reaches the optimal cost of its
+// block.
+class Monitor {
+ public:
+  explicit Monitor(const SolveOptions& options) : options_(options) {}
+
+  // Raises the lower bound by the increase in the objective of a dual problem,
+  // unless bounding has stopped.
+  void Raise(const Rational& increase) {
+    std::unique_lock lock(mutex_);
+    if (bounding_) bound_ += increase;
+  }
+
+  // Stops raising the lower bound, for tableaus whose objective does not bound
+  // the cost of the problem. The bound reached so far remains valid.
+  void StopBounding() {
+    std::unique_lock lock(mutex_);
+    bounding_ = false;
+  }
+
+  // Counts a pivot and reports progress if it is due. Returns false if the
+  // solve should stop.
+  bool Pivot() {
+    std::unique_lock lock(mutex_);
+    if (++pivots_ % kProgressInterval == 0 && options_.progress) {
+      options_.progress({.pivots = pivots_, .bound = bound_});
+    }
+    return !StoppedLocked();
+  }
+
+  // Whether the solve should stop, which stays true once it is.
+  bool Stopped() {
+    std::unique_lock lock(mutex_);
+    return StoppedLocked();
+  }
+
+  // Whether the solve was found to need stopping, without checking again.
+  bool stopped() {
+    std::unique_lock lock(mutex_);
+    return stopped_;
+  }
+
+ private:
+  bool StoppedLocked() {
+    if (!stopped_) {
+      stopped_ = options_.stop_token.stop_requested() ||
+                 (options_.deadline &&
+                  std::chrono::steady_clock::now() >= *options_.deadline);
+    }
+    return stopped_;
+  }
+
+  const SolveOptions& options_;
+  std::mutex mutex_;
+  std::int64_t pivots_ = 0;
+  Rational bound_ = 0;
+  bool bounding_ = true;
+  bool stopped_ = false;
+};
+
+// Adds the entries of the tableau to the bit width histograms of the stats, and
+// returns how many are non-zero. This takes about as long as a pivot, so it is
+// timed as a phase of its own.
+std::int64_t CountBitWidths(SolveStats& stats, const Table<Rational>& tableau) {
+  const PhaseScope phase(&stats.bit_widths);
+  std::int64_t nonzeros = 0;
+  for (int y = 0; y < tableau.height(); y++) {
+    nonzeros += stats.CountBitWidths(tableau[y]);
+  }
+  return nonzeros;
+}
+
+// Optimize a Simplex tableau subject to the given bounds, in place. basis[y] is
+// the column of the variable which is basic in row y, and is kept up to date as
+// the tableau is pivoted. If stats is non-null, the pivots and the bit widths
+// of the tableau entries are recorded, and if monitor is non-null, it is told
+// of each pivot. Returns false if the bounds cannot all be met, or if the
+// monitor stops the solve, in which case the tableau is left part way.
+bool Solve(Table<Rational>& tableau, std::vector<int>& basis,
+           std::span<const Bound> bounds, SolveStats* stats, Monitor* monitor) {
+  if (stats) stats->initial_nonzeros = CountBitWidths(*stats, tableau);
+  std::int64_t nonzeros = stats ? stats->initial_nonzeros : 0;
+  for (int i = 0;; i++) {
+    const TraceSpan span("Pivot", i % kTracedPivotInterval == 0);
     const Rational previous_score = tableau[tableau.height() - 1].back();
-    const std::optional<int> column = PivotColumn(tableau);
+    const std::optional<int> column = PivotColumn(tableau, bounds);
     // If we can't identify a pivot column, the tableau is optimal.
-    if (!column) return tableau;
-    const std::optional<int> row = PivotRow(tableau, *column);
-    if (!row) return std::nullopt;
-    // Use Gaussian elimination to turn the pivot column into the row'th column
-    // of the identity matrix.
-    Multiply(tableau[*row], 1 / tableau[*row][*column]);
-    assert(tableau[*row][*column] == 1);
-    for (int y = 0; y < tableau.height(); y++) {
-      if (y == *row) continue;
-      // The value of the last column must be non-negative: since any
-      // intermediate tableau should represent a basic feasible solution, the
-      // value of the last column must be positive as this directly corresponds
-      // to the value of one of the variables, and all variables must be
-      // non-negative. Note that the value can be 0, and in this case we are
-      // considering a degenerate basic variable which will not increase the
-      // value of the cost function as part of this pivot.
-      assert(tableau[y].back() >= tableau[y][*column] * tableau[*row].back());
-      AddMultiple(tableau[y], tableau[*row], -tableau[y][*column]);
-      assert(tableau[y][*column] == 0);
+    if (!column) break;
+    const std::vector<Rational> pivot_column =
+        GetColumn(tableau, bounds, *column);
+    const std::optional<int> row = PivotRow(tableau, pivot_column);
+    if (!row) return false;
+    Pivot(tableau, *row, pivot_column);
+    basis[*row] = *column;
+    // The value of the last column must be non-negative: since any
+    // intermediate tableau should represent a basic feasible solution, the
+    // value of the last column must be positive as this directly corresponds
+    // to the value of one of the variables, and all variables must be
+    // non-negative. Note that the value can be 0, and in this case we are
+    // considering a degenerate basic variable which will not increase the
+    // value of the cost function as part of this pivot.
+    for (int y = 0; y < tableau.height() - 1; y++) {
+      assert(tableau[y].back() >= 0);
     }
     const Rational score = tableau[tableau.height() - 1].back();
     assert(score >= previous_score);
+    if (stats) {
+      stats->pivots++;
+      if (score == previous_score) stats->degenerate_pivots++;
+      nonzeros = CountBitWidths(*stats, tableau);
+    }
+    if (monitor) {
+      monitor->Raise(score - previous_score);
+      if (!monitor->Pivot()) return false;
+    }
+  }
+  if (stats) stats->final_nonzeros = nonzeros;
+  return true;
+}
+
+// Attempts to make the given columns basic in a freshly built tableau, so that
+// the simplex algorithm can start from a previously optimal basis rather than
+// from the slack basis. Columns which cannot be made basic are skipped. If the
+// resulting basis is infeasible, the tableau and basis are left unchanged and
+// false is returned.
+bool InstallBasis(Table<Rational>& tableau, std::vector<int>& basis,
+                  std::span<const int> columns) {
+  const int r = tableau.height() - 1;
+  std::vector<bool> wanted(tableau.width(), false);
+  for (int column : columns) wanted[column] = true;
+  // Rows whose basic variable is wanted are kept as they are.
+  std::vector<bool> fixed(r, false);
+  for (int y = 0; y < r; y++) fixed[y] = wanted[basis[y]];
+  Table<Rational> result = tableau;
+  std::vector<int> result_basis = basis;
+  for (int column : columns) {
+    if (std::ranges::find(result_basis, column) != result_basis.end()) continue;
+    // Any row whose basic variable is unwanted and which has a non-zero
+    // coefficient will do. Choosing the largest coefficient is not necessary
+    // for exact arithmetic.
+    int row = -1;
+    for (int y = 0; y < r && row == -1; y++) {
+      if (!fixed[y] && result[y][column] != 0) row = y;
+    }
+    if (row == -1) continue;
+    Pivot(result, row, column);
+    result_basis[row] = column;
+    fixed[row] = true;
+  }
+  for (int y = 0; y < r; y++) {
+    if (result[y].back() < 0) return false;
+  }
+  tableau = std::move(result);
+  basis = std::move(result_basis);
+  return true;
+}
+
+// Restores the feasibility of a tableau whose cost row is optimal but in which
+// some basic variables are negative, using the dual simplex algorithm. The cost
+// row stays optimal throughout, so the result is an optimal tableau. If free is
+// non-empty, the variables basic in the rows y where free[y] is set may take
+// any value, and never leave the basis. Returns false if the tableau has no
+// feasible solution, or if the monitor stops the solve.
+bool DualSimplex(Table<Rational>& tableau, std::vector<int>& basis,
+                 std::span<const Bound> bounds, const std::vector<bool>& free,
+                 SolveStats* stats, Monitor* monitor) {
+  const int r = tableau.height() - 1;
+  const int n = tableau.width() - r - 2;
+  const std::span<const Rational> cost_row = tableau[r];
+  std::optional<std::int64_t> nonzeros;
+  for (int i = 0;; i++) {
+    const TraceSpan span("Pivot", i % kTracedPivotInterval == 0);
+    // The most negative basic variable leaves the basis.
+    int row = -1;
+    for (int y = 0; y < r; y++) {
+      if (!free.empty() && free[y]) continue;
+      const Rational& value = tableau[y].back();
+      if (value < 0 && (row == -1 || value < tableau[row].back())) row = y;
+    }
+    if (row == -1) {
+      if (stats && nonzeros) stats->final_nonzeros = *nonzeros;
+      return true;
+    }
+    // The entering variable must have a negative coefficient in the leaving
+    // row so that the leaving variable becomes zero. Of those, the one with
+    // the minimum ratio between its cost and its coefficient keeps the cost row
+    // non-negative.
+    const std::span<const Rational> leaving = tableau[row];
+    std::optional<int> column;
+    Rational best;
+    const auto consider = [&](int x, const Rational& coefficient,
+                              const Rational& cost) {
+      if (coefficient >= 0) return;
+      const Rational ratio = cost / -coefficient;
+      if (!column || ratio < best) {
+        column = x;
+        best = ratio;
+      }
+    };
+    for (int x = 0; x < tableau.width() - 1; x++) {
+      consider(x, leaving[x], cost_row[x]);
+    }
+    // The entries of a bound are computed from the slack columns of its
+    // recipes, as in GetColumn.
+    for (int k = 0; k < std::ssize(bounds); k++) {
+      Rational coefficient = 0;
+      Rational cost = bounds[k].limit;
+      for (const auto& [recipe, weight] : bounds[k].terms) {
+        coefficient -= weight * leaving[n + recipe];
+        cost -= weight * cost_row[n + recipe];
+      }
+      consider(-1 - k, coefficient, cost);
+    }
+    if (!column) return false;
+    const Rational previous_score = cost_row.back();
+    Pivot(tableau, row, GetColumn(tableau, bounds, *column));
+    basis[row] = *column;
+    assert(cost_row.back() <= previous_score);
+    if (stats) {
+      stats->pivots++;
+      if (cost_row.back() == previous_score) stats->degenerate_pivots++;
+      nonzeros = CountBitWidths(*stats, tableau);
+    }
+    if (monitor && !monitor->Pivot()) return false;
+  }
+}
+
+// Given a tableau which is optimal for the first of the objectives, makes it
+// optimal for each of the others in turn among the solutions which are optimal
+// for the ones before it.
+//
+// The recipe costs only appear in the final column, which is the sum of the
+// slack columns weighted by the costs, so it can be recomputed for the next
+// objective while the cost row stays optimal, and the dual simplex algorithm
+// then restores feasibility. The solutions which are optimal for an objective
+// are those which do not use the recipes with a positive reduced cost, and
+// which meet exactly the demands and bounds with a positive price. Those are
+// the variables which are basic with a non-zero value in the optimal tableau,
+// and the solutions are fixed to them by making them free, which drops the
+// constraints of the dual problem on them.
+bool MinimizeInTurn(Table<Rational>& tableau, std::vector<int>& basis,
+                    std::span<const Bound> bounds, const Input& input,
+                    std::span<const Objective> objectives, SolveStats* stats,
+                    Monitor* monitor) {
+  const int r = tableau.height() - 1;
+  const int n = tableau.width() - r - 2;
+  std::vector<bool> free(r, false);
+  for (const Objective& objective : objectives.subspan(1)) {
+    for (int y = 0; y < r; y++) {
+      if (tableau[y].back() != 0) free[y] = true;
+    }
+    std::vector<Rational> costs(r);
+    for (int i = 0; i < r; i++) {
+      costs[i] = ObjectiveCost(objective, input.recipes[i]);
+    }
+    for (int y = 0; y <= r; y++) {
+      const std::span<Rational> row = tableau[y];
+      Rational value = 0;
+      for (int i = 0; i < r; i++) {
+        if (costs[i] != 0 && row[n + i] != 0) value += costs[i] * row[n + i];
+      }
+      row.back() = value;
+    }
+    if (!DualSimplex(tableau, basis, bounds, free, stats, monitor)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Adds rows for the given recipes to a tableau, along with a slack column for
+// each, so that recipes[k] is given row r + k where r is the previous number of
+// recipe rows. The new rows are expressed in terms of the current basis, with
+// their slack variables basic, which leaves the cost row unchanged. In an
+// optimal tableau, the new slack variables are then negative for exactly those
+// recipes which would reduce the cost.
+void AddRecipes(Table<Rational>& tableau, std::vector<int>& basis,
+                std::span<const std::string_view> resources,
+                const Input& input, std::span<const int> recipes) {
+  const int n = resources.size();
+  const int r = tableau.height() - 1;
+  const int m = recipes.size();
+  Table<Rational> result(n + r + m + 2, r + m + 1, tableau.pool());
+  // The existing rows keep their columns, except for the last two columns,
+  // which move past the new slack columns.
+  const auto copy = [&](int from, int to) {
+    const std::span<const Rational> source = tableau[from];
+    const std::span<Rational> destination = result[to];
+    std::copy(source.begin(), source.begin() + n + r, destination.begin());
+    destination[n + r + m] = source[n + r];
+    destination.back() = source.back();
+  };
+  for (int y = 0; y < r; y++) copy(y, y);
+  copy(r, r + m);
+  for (int k = 0; k < m; k++) {
+    const std::span<Rational> row = result[r + k];
+    SetRecipeRow(row, resources, input.recipes[recipes[k]]);
+    row[n + r + k] = 1;
+    // Each existing row is zero in the basic columns of the other rows, so the
+    // basic columns can be eliminated in any order.
+    for (int y = 0; y < r; y++) {
+      const Rational x = row[basis[y]];
+      if (x != 0) AddMultiple(row, result[y], -x);
+    }
+    basis.push_back(n + r + k);
   }
+  tableau = std::move(result);
 }
 
 // Given a Simplex tableau representing an optimal solution for the dual
@@ -260,6 +696,317 @@ Rational GetCost(const Table<Rational>& tableau) {
   return tableau[tableau.height() - 1].back();
 }
 
+// A node of the branch-and-bound search: the optimal tableau of its parent,
+// along with the bounds of the parent and the one which the node adds. Adding a
+// bound only adds a column to the dual problem, so the parent's tableau stays
+// feasible and the simplex algorithm continues from where the parent left off.
+struct Node {
+  Table<Rational> tableau;
+  std::vector<int> basis;
+  std::vector<Bound> bounds;
+  // The cost of the parent, which the node cannot improve on.
+  Rational lower_bound;
+};
+
+// The nodes waiting to be explored by the workers of a branch-and-bound search.
+// Each worker explores its own nodes depth first, which reaches solutions
+// quickly, and steals the shallowest node of another worker when it runs out,
+// which gives it a large subtree to work on.
+class NodeQueue {
+ public:
+  explicit NodeQueue(int workers) : nodes_(workers) {}
+
+  void Push(int worker, Node node) {
+    {
+      std::unique_lock lock(mutex_);
+      nodes_[worker].push_back(std::move(node));
+      pending_++;
+    }
+    ready_.notify_one();
+  }
+
+  // Returns the next node for a worker, waiting while other workers are still
+  // exploring nodes which may have children. Returns std::nullopt once every
+  // node has been explored.
+  std::optional<Node> Pop(int worker) {
+    std::unique_lock lock(mutex_);
+    const int workers = nodes_.size();
+    while (true) {
+      if (std::deque<Node>& own = nodes_[worker]; !own.empty()) {
+        Node node = std::move(own.back());
+        own.pop_back();
+        return node;
+      }
+      for (int k = 1; k < workers; k++) {
+        std::deque<Node>& other = nodes_[(worker + k) % workers];
+        if (other.empty()) continue;
+        Node node = std::move(other.front());
+        other.pop_front();
+        return node;
+      }
+      if (pending_ == 0) return std::nullopt;
+      ready_.wait(lock);
+    }
+  }
+
+  // Marks a node returned by Pop as explored, once its children are pushed.
+  void Done() {
+    std::unique_lock lock(mutex_);
+    if (--pending_ == 0) ready_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::vector<std::deque<Node>> nodes_;
+  // The number of nodes which have been pushed but not yet explored.
+  int pending_ = 0;
+};
+
+// Finds the cheapest solution in which the use of each recipe is a whole
+// multiple of the granularity, given the optimal tableau of the continuous
+// problem. A recipe whose use is not a multiple is branched on: one child
+// bounds its use from above by the multiple below, and the other from below by
+// the multiple above, as a bound with a negative weight. Nodes which cannot
+// beat the cheapest solution found so far are pruned, as are all remaining
+// nodes once options.max_nodes have been solved or the monitor stops the
+// search. On success, the tableau and basis are replaced with those of the
+// cheapest solution. Returns false if no solution was found, which can only
+// happen if the bounds are too tight or the search was cut short.
+bool BranchAndBound(Table<Rational>& tableau, std::vector<int>& basis,
+                    std::span<const Bound> bounds, const SolveOptions& options,
+                    SolveStats* stats, Monitor* monitor) {
+  const TraceSpan span("BranchAndBound");
+  // The bounds added by branching make the objectives of the nodes bound the
+  // cost of their subtrees rather than of the continuous problem, which stays
+  // the lower bound.
+  if (monitor) monitor->StopBounding();
+  const int r = tableau.height() - 1;
+  const int n = tableau.width() - r - 2;
+  const Rational& granularity = *options.granularity;
+  // The cheapest solution found so far and the number of nodes solved, shared
+  // by the workers.
+  std::mutex mutex;
+  std::optional<Node> best;
+  std::int64_t solved_nodes = 0;
+  const auto improves = [&](const Rational& cost) {
+    std::unique_lock lock(mutex);
+    return !best || cost < GetCost(best->tableau);
+  };
+  const auto reserve_node = [&] {
+    std::unique_lock lock(mutex);
+    if (options.max_nodes > 0 && solved_nodes >= options.max_nodes) {
+      return false;
+    }
+    if (monitor && monitor->Stopped()) return false;
+    solved_nodes++;
+    return true;
+  };
+  const int workers = NumThreads(options.threads);
+  NodeQueue queue(workers);
+  std::vector<SolveStats> worker_stats(stats ? workers : 0);
+  const auto explore = [&](int worker, Node node) {
+    if (!improves(node.lower_bound) || !reserve_node()) return;
+    SolveStats* const s = stats ? &worker_stats[worker] : nullptr;
+    const PhaseScope phase(s ? &s->pivot_loop : nullptr,
+                           s ? &s->bit_widths : nullptr);
+    if (s) s->nodes++;
+    if (!Solve(node.tableau, node.basis, node.bounds, s, monitor)) return;
+    const Rational cost = GetCost(node.tableau);
+    if (!improves(cost)) return;
+    // Branch on the recipe whose use is furthest from a multiple, which is
+    // the one that the bounds of its children change the most.
+    const std::span<const Rational> uses = node.tableau[r].subspan(n, r);
+    // Whether the use of a recipe has been rounded up on the path to the node,
+    // which is the only kind of bound with a negative weight.
+    const auto rounded_up = [&](int i) {
+      return std::ranges::any_of(node.bounds, [&](const Bound& bound) {
+        return bound.terms.front().first == i && bound.terms.front().second < 0;
+      });
+    };
+    int branch = -1;
+    Rational multiple, distance = 0;
+    bool round_up = false;
+    for (int i = 0; i < r; i++) {
+      const Rational steps = uses[i] / granularity;
+      const Rational whole(steps.numerator() / steps.denominator(), 1);
+      const Rational d = std::min(steps - whole, whole + 1 - steps);
+      if (d > distance) {
+        branch = i;
+        multiple = whole * granularity;
+        distance = d;
+        round_up = !rounded_up(i);
+      }
+    }
+    if (branch == -1) {
+      std::unique_lock lock(mutex);
+      if (!best || cost < GetCost(best->tableau)) best = std::move(node);
+      return;
+    }
+    Node up{.tableau = node.tableau,
+            .basis = node.basis,
+            .bounds = node.bounds,
+            .lower_bound = cost};
+    up.bounds.push_back(
+        {.terms = {{branch, -1}}, .limit = -(multiple + granularity)});
+    node.bounds.push_back({.terms = {{branch, 1}}, .limit = multiple});
+    node.lower_bound = cost;
+    // The child explored first is pushed last. Rounding up usually leads to a
+    // solution to prune with quickly, but it is only done once per recipe on
+    // each path, as otherwise it could chase a cycle of recipes forever, with
+    // each one using up the surplus of the one before.
+    if (round_up) {
+      queue.Push(worker, std::move(node));
+      queue.Push(worker, std::move(up));
+    } else {
+      queue.Push(worker, std::move(up));
+      queue.Push(worker, std::move(node));
+    }
+  };
+  queue.Push(0, Node{.tableau = std::move(tableau),
+                     .basis = basis,
+                     .bounds = std::vector(bounds.begin(), bounds.end()),
+                     .lower_bound = 0});
+  ParallelFor(
+      workers,
+      [&](int worker) {
+        while (std::optional<Node> node = queue.Pop(worker)) {
+          explore(worker, std::move(*node));
+          queue.Done();
+        }
+      },
+      workers);
+  // The tableau of the block stays that of the continuous problem, so the
+  // non-zero entries of the node tableaus are only added to the histograms.
+  for (SolveStats& s : worker_stats) {
+    s.initial_nonzeros = s.final_nonzeros = 0;
+    *stats += s;
+  }
+  if (!best) return false;
+  tableau = std::move(best->tableau);
+  basis = std::move(best->basis);
+  return true;
+}
+
+// Reads the sensitivity of the solution from an optimal tableau, as described
+// in data.hpp. The entries of the tableau relate to the primal problem as
+// follows:
+//
+//   * The value of a basic resource column is the price of the resource per
+//     unit/s, and non-basic resources have no price.
+//   * The value of a basic slack column is the reduced cost of its recipe, and
+//     non-basic slack columns belong to the recipes in use.
+//   * Changing the demand for a resource by d per second subtracts d from its
+//     entry in the initial cost row. If the resource is basic in row k, the
+//     cost row must then add d times row k to keep its column zero, and the
+//     basis stays optimal for as long as the cost row stays non-negative. If
+//     it is not basic, only its own entry changes: the demand can rise until
+//     it uses up the surplus of the resource, which is that entry.
+//   * Changing the cost of recipe i by d adds d times its slack column to the
+//     final column, since the slack column holds the multiple of each initial
+//     row which makes up each row, and the basis stays optimal for as long as
+//     the final column stays non-negative.
+Sensitivity GetSensitivity(const Table<Rational>& tableau,
+                           std::span<const int> basis,
+                           std::span<const Bound> bounds,
+                           std::span<const std::string_view> resources,
+                           const Input& input,
+                           std::span<const Demand> demands) {
+  const TraceSpan span("GetSensitivity");
+  const int r = tableau.height() - 1;
+  const int n = tableau.width() - r - 2;
+  const std::span<const Rational> cost_row = tableau[r];
+  // row[x] is the row in which column x is basic, or -1 if it is not basic.
+  std::vector<int> row(n + r, -1);
+  for (int y = 0; y < r; y++) {
+    if (basis[y] >= 0) row[basis[y]] = y;
+  }
+  const auto value = [&](int x) {
+    return row[x] == -1 ? Rational(0) : tableau[row[x]].back();
+  };
+  Sensitivity sensitivity;
+  for (int j = 0; j < n; j++) sensitivity.prices[resources[j]] = value(j) / 60;
+  for (int i = 0; i < r; i++) {
+    sensitivity.reduced_costs.push_back(value(n + i));
+    const Rational& cost = input.recipes[i].cost;
+    Range& range = sensitivity.cost_ranges.emplace_back();
+    range.lower = 0;
+    for (int y = 0; y < r; y++) {
+      const Rational& x = tableau[y][n + i];
+      if (x > 0) {
+        range.lower = std::max(*range.lower, cost - tableau[y].back() / x);
+      } else if (x < 0) {
+        const Rational upper = cost + tableau[y].back() / -x;
+        if (!range.upper || upper < *range.upper) range.upper = upper;
+      }
+    }
+  }
+  // The bounds which are not basic also have entries in the cost row.
+  std::vector<std::vector<Rational>> bound_columns;
+  for (int k = 0; k < std::ssize(bounds); k++) {
+    if (std::ranges::find(basis, -1 - k) != basis.end()) continue;
+    bound_columns.push_back(GetColumn(tableau, bounds, -1 - k));
+  }
+  std::map<std::string_view, Rational> totals;
+  for (const auto& [resource, units_per_minute] : demands) {
+    totals[resource] += units_per_minute;
+  }
+  for (const auto& [resource, total] : totals) {
+    const int j = ResourceColumn(resources, resource);
+    Range& range = sensitivity.demand_ranges[resource];
+    const int k = row[j];
+    if (k == -1) {
+      range.upper = total + 60 * cost_row[j];
+      continue;
+    }
+    // Each non-basic column limits the change d per second to one side.
+    const auto limit = [&](const Rational& cost, const Rational& x) {
+      if (x > 0) {
+        const Rational lower = total - 60 * cost / x;
+        if (!range.lower || lower > *range.lower) range.lower = lower;
+      } else if (x < 0) {
+        const Rational upper = total + 60 * cost / -x;
+        if (!range.upper || upper < *range.upper) range.upper = upper;
+      }
+    };
+    for (int x = 0; x < n + r; x++) {
+      if (row[x] == -1) limit(cost_row[x], tableau[k][x]);
+    }
+    for (const std::vector<Rational>& column : bound_columns) {
+      limit(column[r], column[k]);
+    }
+  }
+  return sensitivity;
+}
+
+// Reads the values of the dual problem from an optimal tableau, which are the
+// values of its basic columns. Those of resources and resource limits are per
+// unit/s, like the rates in the tableau, so they are converted to units/min.
+Certificate GetCertificate(const Table<Rational>& tableau,
+                           std::span<const int> basis,
+                           std::span<const int> origins,
+                           std::span<const std::string_view> resources,
+                           const Input& input) {
+  const int r = tableau.height() - 1;
+  const int n = tableau.width() - r - 2;
+  Certificate certificate;
+  for (int y = 0; y < r; y++) {
+    const int column = basis[y];
+    const Rational& value = tableau[y].back();
+    if (column >= n || value == 0) continue;
+    if (column >= 0) {
+      certificate.prices[resources[column]] = value / 60;
+    } else if (const int origin = origins[-1 - column]; origin >= 0) {
+      certificate.recipe_limits.resize(r);
+      certificate.recipe_limits[origin] = value;
+    } else {
+      certificate.resource_limits.resize(input.limits.size());
+      certificate.resource_limits[-1 - origin] = value / 60;
+    }
+  }
+  return certificate;
+}
+
 struct Rates {
   std::map<std::string_view, Rational> total, net;
 };
@@ -282,10 +1029,13 @@ Rates GetRates(const Input& input, std::span<const Rational> uses) {
   return rates;
 }
 
-void Verify(const Input& input) {
+// Checks that every resource which is demanded or consumed has a recipe, and
+// reports those which do not to error, if non-null, or otherwise to stderr.
+bool Verify(const Input& input, std::span<const Demand> demands,
+            std::string* error = nullptr) {
   std::set<std::string_view> required;
   std::set<std::string_view> producible;
-  for (const auto& [resource, rate] : input.demands) {
+  for (const auto& [resource, rate] : demands) {
     if (rate > 0) required.insert(resource);
   }
   for (const auto& recipe : input.recipes) {
@@ -298,34 +1048,928 @@ void Verify(const Input& input) {
   }
   bool valid = true;
   for (std::string_view resource : required) {
-    if (!producible.contains(resource)) {
+    if (producible.contains(resource)) continue;
+    if (error) {
+      if (!error->empty()) *error += "; ";
+      *error += "no recipe for " + std::string(resource);
+    } else {
       std::cerr << "error: no recipe for " << resource << '\n';
-      valid = false;
     }
+    valid = false;
   }
-  if (!valid) std::exit(1);
+  return valid;
 }
 
-}  // namespace
+// Maps the variables of a basis onto the columns of a tableau built for the
+// given resources and recipes. Variables which no longer exist are dropped.
+std::vector<int> BasisColumns(const Basis& basis,
+                              std::span<const std::string_view> resources,
+                              const Input& input) {
+  const int n = resources.size();
+  const int r = input.recipes.size();
+  std::vector<int> columns;
+  for (const std::string& resource : basis.resources) {
+    const auto i = std::ranges::lower_bound(resources, resource);
+    if (i != resources.end() && *i == resource) {
+      columns.push_back(i - resources.begin());
+    }
+  }
+  // Identical recipes share a key, so each key maps to a list of recipes which
+  // are handed out in order.
+  std::map<std::string, std::vector<int>> recipes;
+  for (int i = r - 1; i >= 0; i--) {
+    recipes[RecipeKey(input.recipes[i])].push_back(i);
+  }
+  for (const std::string& recipe : basis.recipes) {
+    const auto i = recipes.find(recipe);
+    if (i == recipes.end() || i->second.empty()) continue;
+    columns.push_back(n + i->second.back());
+    i->second.pop_back();
+  }
+  return columns;
+}
 
-std::optional<Solution> Solve(const Input& input) {
-  Verify(input);
+// Chooses a small set of recipes which can meet the demands on their own. Each
+// resource is assigned the first recipe found which produces it from resources
+// that have already been assigned a recipe, so that the assignments cannot form
+// a cycle, and then only the recipes needed for the demands are chosen. Returns
+// std::nullopt if there is no such set, as is the case when a demanded resource
+// can only be produced by a cycle of recipes.
+std::optional<std::vector<int>> InitialRecipes(
+    const Input& input, std::span<const Demand> demands,
+    std::span<const std::string_view> resources) {
+  const int n = resources.size();
+  const int r = input.recipes.size();
+  const auto column = [&](std::string_view name) {
+    return ResourceColumn(resources, name);
+  };
+  // Resources are assigned recipes in rounds, with the recipes of each round
+  // only using resources assigned in earlier rounds.
+  std::vector<int> producer(n, -1);
+  std::vector<bool> considered(r, false);
+  for (bool changed = true; changed;) {
+    changed = false;
+    std::vector<int> next = producer;
+    for (int i = 0; i < r; i++) {
+      if (considered[i]) continue;
+      const Recipe& recipe = input.recipes[i];
+      const bool ready = std::ranges::all_of(recipe.inputs, [&](const auto& x) {
+        return x.second <= 0 || producer[column(x.first)] != -1;
+      });
+      if (!ready) continue;
+      considered[i] = true;
+      for (const auto& [resource, quantity] : recipe.outputs) {
+        int& p = next[column(resource)];
+        if (quantity > 0 && p == -1) {
+          p = i;
+          changed = true;
+        }
+      }
+    }
+    producer = std::move(next);
+  }
+  std::vector<bool> needed(n, false);
+  std::vector<int> pending;
+  const auto need = [&](std::string_view resource) {
+    const int j = column(resource);
+    if (!needed[j]) pending.push_back(j);
+    needed[j] = true;
+  };
+  for (const auto& [resource, rate] : demands) {
+    if (rate > 0) need(resource);
+  }
+  std::vector<int> recipes;
+  std::vector<bool> chosen(r, false);
+  while (!pending.empty()) {
+    const int i = producer[pending.back()];
+    pending.pop_back();
+    if (i == -1) return std::nullopt;
+    if (chosen[i]) continue;
+    chosen[i] = true;
+    recipes.push_back(i);
+    for (const auto& [resource, quantity] : input.recipes[i].inputs) {
+      if (quantity > 0) need(resource);
+    }
+  }
+  return recipes;
+}
+
+// Returns the values of the dual variables for a tableau, which are the prices
+// of the resources: the marginal cost of demanding more of each one.
+std::vector<Rational> Prices(const Table<Rational>& tableau,
+                             std::span<const int> basis, int n) {
+  std::vector<Rational> prices(n);
+  for (int y = 0; y < std::ssize(basis); y++) {
+    if (basis[y] < n) prices[basis[y]] = tableau[y].back();
+  }
+  return prices;
+}
+
+// Returns the cost of a recipe less the value of its net production at the
+// given prices. Using a recipe with a negative reduced cost in place of the
+// current recipes would reduce the cost.
+Rational ReducedCost(const Recipe& recipe,
+                     std::span<const std::string_view> resources,
+                     std::span<const Rational> prices) {
+  Rational value = 0;
+  for (const auto& [resource, quantity] : recipe.inputs) {
+    const Rational& price = prices[ResourceColumn(resources, resource)];
+    if (price != 0) value -= quantity * price;
+  }
+  for (const auto& [resource, quantity] : recipe.outputs) {
+    const Rational& price = prices[ResourceColumn(resources, resource)];
+    if (price != 0) value += quantity * price;
+  }
+  return recipe.cost - value / recipe.duration;
+}
+
+struct BlockSolution {
+  std::vector<Rational> uses;
+  Rational cost;
+  // The variables of the optimal basis, with recipes given as indices into the
+  // recipes of the block.
+  std::vector<std::string_view> basic_resources;
+  std::vector<int> basic_recipes;
+  std::optional<Sensitivity> sensitivity;
+  // The values of the dual problem, with recipes given as indices into the
+  // recipes of the block, if requested.
+  std::optional<Certificate> certificate;
+};
+
+// Solves a problem by column generation. The tableau starts out with a small
+// set of recipes which can meet the demands, along with the given recipes, and
+// the other recipes are only added once they would reduce the cost at the
+// current prices of the resources. Since most alternate recipes never become
+// worthwhile, the tableau stays much smaller than the full one, and the
+// optimal cost is the same. If basic is non-empty, the simplex algorithm
+// starts from the basis with those columns, given as by BasisColumns, when it
+// is feasible. The tableau is allocated from the pool if it is non-null.
+// Returns std::nullopt if no starting set of recipes could be found, in which
+// case the full tableau must be solved.
+std::optional<BlockSolution> SolveBlockLazily(
+    const Input& input, std::span<const Demand> demands,
+    std::span<const std::string_view> resources, std::span<const int> recipes,
+    std::span<const int> basic, bool certify, TablePool* pool,
+    SolveStats* stats, Monitor* monitor) {
+  const TraceSpan span("SolveBlockLazily");
+  // The objective of a tableau with only some of the recipes overshoots the
+  // optimal cost, as fewer recipes constrain the dual problem less.
+  if (monitor) monitor->StopBounding();
+  const auto measure = [&](PhaseStats SolveStats::*phase) {
+    return PhaseScope(stats ? &(stats->*phase) : nullptr);
+  };
+  const int n = resources.size();
+  const int r = input.recipes.size();
+  // active[y] is the recipe in row y of the tableau.
+  std::vector<int> active;
+  std::vector<bool> is_active(r, false);
+  std::vector<int> basis;
+  Table<Rational> tableau;
+  {
+    const TraceSpan span("BuildTableau");
+    const PhaseScope phase = measure(&SolveStats::build_tableau);
+    std::optional<std::vector<int>> initial =
+        InitialRecipes(input, demands, resources);
+    if (!initial) return std::nullopt;
+    active = std::move(*initial);
+    for (int i : active) is_active[i] = true;
+    for (int i : recipes) {
+      if (is_active[i]) continue;
+      active.push_back(i);
+      is_active[i] = true;
+    }
+    std::ranges::sort(active);
+    tableau = BuildTableau(resources, Input(), demands, pool);
+    AddRecipes(tableau, basis, resources, input, active);
+  }
+  {
+    const PhaseScope phase(stats ? &stats->pivot_loop : nullptr,
+                           stats ? &stats->bit_widths : nullptr);
+    if (!basic.empty()) {
+      // Each active recipe has the slack column of its row.
+      std::vector<int> columns;
+      for (int column : basic) {
+        if (column < n) {
+          columns.push_back(column);
+        } else if (is_active[column - n]) {
+          columns.push_back(
+              n + (std::ranges::lower_bound(active, column - n) -
+                   active.begin()));
+        }
+      }
+      InstallBasis(tableau, basis, columns);
+    }
+    if (!Solve(tableau, basis, {}, stats, monitor)) return std::nullopt;
+    std::vector<int> candidates;
+    while (true) {
+      if (stats) stats->pricing_rounds++;
+      const std::vector<Rational> prices = Prices(tableau, basis, n);
+      candidates.clear();
+      for (int i = 0; i < r; i++) {
+        if (is_active[i]) continue;
+        if (ReducedCost(input.recipes[i], resources, prices) < 0) {
+          candidates.push_back(i);
+        }
+      }
+      if (candidates.empty()) break;
+      AddRecipes(tableau, basis, resources, input, candidates);
+      for (int i : candidates) {
+        active.push_back(i);
+        is_active[i] = true;
+      }
+      if (!DualSimplex(tableau, basis, {}, {}, stats, monitor)) {
+        return std::nullopt;
+      }
+    }
+  }
+  if (stats) {
+    stats->rows = tableau.height();
+    stats->columns = tableau.width();
+    stats->active_recipes = active.size();
+  }
+  BlockSolution solution;
+  {
+    const PhaseScope phase = measure(&SolveStats::extract_solution);
+    const std::vector<Rational> uses = ExtractSolution(tableau);
+    solution.uses.resize(r);
+    for (std::size_t y = 0; y < active.size(); y++) {
+      solution.uses[active[y]] = uses[y];
+    }
+  }
+  solution.cost = GetCost(tableau);
+  for (int column : basis) {
+    if (column < n) {
+      solution.basic_resources.push_back(resources[column]);
+    } else {
+      solution.basic_recipes.push_back(active[column - n]);
+    }
+  }
+  // Recipes which were never added are unused, so their slack variables are
+  // basic in the full tableau.
+  for (int i = 0; i < r; i++) {
+    if (!is_active[i]) solution.basic_recipes.push_back(i);
+  }
+  // The final prices give no recipe a negative reduced cost, including those
+  // which were never added.
+  if (certify) {
+    Certificate& certificate = solution.certificate.emplace();
+    const std::vector<Rational> prices = Prices(tableau, basis, n);
+    for (int j = 0; j < n; j++) {
+      if (prices[j] != 0) certificate.prices[resources[j]] = prices[j] / 60;
+    }
+  }
+  return solution;
+}
+
+// Solves a generalized network without a tableau. The basis of the network is
+// converted to that of the tableau: the producers are non-basic in the dual
+// problem, while their resources are basic.
+std::optional<BlockSolution> SolveBlockAsNetwork(
+    const Input& input, std::span<const Demand> demands, bool certify,
+    SolveStats* stats, Monitor* monitor) {
+  std::optional<NetworkSolution> network;
+  {
+    const PhaseScope phase(stats ? &stats->pivot_loop : nullptr);
+    network = SolveNetwork(input, demands);
+  }
+  if (!network) return std::nullopt;
+  if (stats) stats->network_blocks++;
+  if (monitor) monitor->Raise(network->cost);
+  BlockSolution solution{.uses = std::move(network->uses),
+                         .cost = network->cost,
+                         .basic_resources = {},
+                         .basic_recipes = {},
+                         .sensitivity = std::nullopt,
+                         .certificate = std::nullopt};
+  if (certify) {
+    Certificate& certificate = solution.certificate.emplace();
+    for (const auto& [resource, price] : network->prices) {
+      certificate.prices[resource] = price / 60;
+    }
+  }
+  std::vector<bool> produces(input.recipes.size(), false);
+  for (const auto& [resource, recipe] : network->producers) {
+    solution.basic_resources.push_back(resource);
+    produces[recipe] = true;
+  }
+  for (int i = 0; i < std::ssize(produces); i++) {
+    if (!produces[i]) solution.basic_recipes.push_back(i);
+  }
+  return solution;
+}
+
+// Solves a problem from a basis which is already known, such as a warm start,
+// without a tableau. The uses of the recipes whose slack variables are not
+// basic solve a square system, with a row for each basic resource, which must
+// then be produced exactly as demanded, and the prices of the basic resources
+// solve the transposed system, with a row for each of those recipes, which
+// must then have no reduced cost. Both are solved by SolveModular, and the
+// solution is optimal if the uses and prices are non-negative, every demand
+// is met and no recipe has a negative reduced cost. Returns std::nullopt
+// otherwise, or if the basis does not give a square system, in which case it
+// must be installed in a tableau. Like column generation, this does not
+// support bounds.
+std::optional<BlockSolution> SolveBlockFromBasis(
+    const Input& input, std::span<const Demand> demands,
+    std::span<const std::string_view> resources, std::span<const int> columns,
+    int threads, bool certify, SolveStats* stats) {
+  const TraceSpan span("SolveBlockFromBasis");
+  const PhaseScope phase(stats ? &stats->pivot_loop : nullptr);
+  const int n = resources.size();
+  const int r = input.recipes.size();
+  // row[j] is the row of basic resource j, and column[i] is the column of
+  // recipe i if its slack variable is not basic, or else -1.
+  std::vector<int> row(n, -1), column(r, 0);
+  std::vector<int> basic_resources, used;
+  for (int c : columns) {
+    if (c < n) {
+      row[c] = basic_resources.size();
+      basic_resources.push_back(c);
+    } else {
+      column[c - n] = -1;
+    }
+  }
+  for (int i = 0; i < r; i++) {
+    if (column[i] == -1) continue;
+    column[i] = used.size();
+    used.push_back(i);
+  }
+  const int m = used.size();
+  if (std::ssize(basic_resources) != m) return std::nullopt;
+  Table<Rational> primal(m + 1, m), dual(m + 1, m);
+  std::vector<Rational> rates(n + 1);
+  for (int k = 0; k < m; k++) {
+    std::ranges::fill(rates, 0);
+    SetRecipeRow(rates, resources, input.recipes[used[k]]);
+    for (int j : basic_resources) {
+      primal[row[j]][k] = rates[j];
+      dual[k][row[j]] = rates[j];
+    }
+    dual[k][m] = rates.back();
+  }
+  std::vector<Rational> required(n);
+  for (const auto& [resource, units_per_minute] : demands) {
+    required[ResourceColumn(resources, resource)] += units_per_minute / 60;
+  }
+  for (int j : basic_resources) primal[row[j]][m] = required[j];
+  int primal_primes = 0, dual_primes = 0;
+  const std::optional<std::vector<Rational>> uses =
+      SolveModular(primal, threads, &primal_primes);
+  if (!uses) return std::nullopt;
+  const std::optional<std::vector<Rational>> basic_prices =
+      SolveModular(dual, threads, &dual_primes);
+  if (!basic_prices) return std::nullopt;
+  if (stats) stats->primes += primal_primes + dual_primes;
+  // The primal solution must be feasible.
+  BlockSolution solution{.uses = std::vector<Rational>(r),
+                         .cost = 0,
+                         .basic_resources = {},
+                         .basic_recipes = {},
+                         .sensitivity = std::nullopt,
+                         .certificate = std::nullopt};
+  std::vector<Rational> production(n);
+  for (int k = 0; k < m; k++) {
+    const Rational& use = (*uses)[k];
+    if (use < 0) return std::nullopt;
+    if (use == 0) continue;
+    const Recipe& recipe = input.recipes[used[k]];
+    solution.uses[used[k]] = use;
+    solution.cost += recipe.cost * use;
+    for (const auto& [resource, quantity] : recipe.inputs) {
+      production[ResourceColumn(resources, resource)] -=
+          use * quantity / recipe.duration;
+    }
+    for (const auto& [resource, quantity] : recipe.outputs) {
+      production[ResourceColumn(resources, resource)] +=
+          use * quantity / recipe.duration;
+    }
+  }
+  for (int j = 0; j < n; j++) {
+    if (production[j] < required[j]) return std::nullopt;
+  }
+  // So must the dual solution.
+  std::vector<Rational> prices(n);
+  for (int j : basic_resources) {
+    prices[j] = (*basic_prices)[row[j]];
+    if (prices[j] < 0) return std::nullopt;
+  }
+  for (int i = 0; i < r; i++) {
+    if (column[i] != -1) continue;
+    if (ReducedCost(input.recipes[i], resources, prices) < 0) {
+      return std::nullopt;
+    }
+  }
+  if (stats) stats->basis_blocks++;
+  for (int j : basic_resources) {
+    solution.basic_resources.push_back(resources[j]);
+  }
+  for (int i = 0; i < r; i++) {
+    if (column[i] == -1) solution.basic_recipes.push_back(i);
+  }
+  if (certify) {
+    Certificate& certificate = solution.certificate.emplace();
+    for (int j : basic_resources) {
+      if (prices[j] != 0) certificate.prices[resources[j]] = prices[j] / 60;
+    }
+  }
+  return solution;
+}
+
+// Solves a problem by the interior-point method, followed by crossover to an
+// exact optimal basis. The recipes which have no reduced cost in the
+// approximate solution seed column generation, with the resources which it
+// prices and the slack columns of the other recipes as the starting basis.
+// Rounding errors can misidentify a few variables near ties, and when several
+// prices are optimal, the tableau may not have the recipes to support those
+// which the interior-point method found, but the simplex algorithm corrects
+// the basis in exact arithmetic and the pricing rounds check every recipe, so
+// the solution is exactly optimal either way. Returns std::nullopt
+// if the interior-point method does not converge, in which case the problem
+// must be solved by the simplex algorithm alone.
+std::optional<BlockSolution> SolveBlockByInteriorPoint(
+    const Input& input, std::span<const Demand> demands,
+    std::span<const std::string_view> resources, int threads, bool certify,
+    TablePool* pool, SolveStats* stats, Monitor* monitor) {
+  std::optional<InteriorSolution> interior;
+  {
+    const PhaseScope phase(stats ? &stats->interior_point : nullptr);
+    interior = SolveInterior(input, demands, resources, threads,
+                             [&] { return monitor && monitor->Stopped(); });
+  }
+  if (!interior) return std::nullopt;
+  if (stats) {
+    stats->interior_point_blocks++;
+    stats->interior_point_iterations += interior->iterations;
+  }
+  const int n = resources.size();
+  const int r = input.recipes.size();
+  std::vector<int> recipes, basic;
+  for (int j = 0; j < n; j++) {
+    if (interior->prices[j] > interior->surpluses[j]) basic.push_back(j);
+  }
+  // Recipes which are used, or which are not but have no reduced cost, are
+  // what set the prices, so they are the recipes in the basis.
+  for (int i = 0; i < r; i++) {
+    const double reduced_cost = interior->reduced_costs[i];
+    if (reduced_cost < interior->uses[i] ||
+        reduced_cost <= kNoReducedCost *
+                            (1 + static_cast<double>(input.recipes[i].cost))) {
+      recipes.push_back(i);
+    } else {
+      basic.push_back(n + i);
+    }
+  }
+  return SolveBlockLazily(input, demands, resources, recipes, basic, certify,
+                          pool, stats, monitor);
+}
+
+// Solves a problem on a single tableau, unless it can be solved as a network,
+// from the warm start basis, by the interior-point method or by column
+// generation. None of these support bounds, so problems with bounds are always
+// solved on a single tableau, as are problems with a granularity, whose
+// branch-and-bound search adds bounds to the tableau, and problems whose
+// sensitivity is analyzed, which is read from the full tableau.
+std::optional<BlockSolution> SolveBlock(const Input& input,
+                                        std::span<const Demand> demands,
+                                        const SolveOptions& options,
+                                        SolveStats* stats, Monitor* monitor) {
+  if (monitor && monitor->Stopped()) return std::nullopt;
+  std::vector<int> origins;
+  const std::vector<Bound> bounds = GetBounds(input, &origins);
+  // Whole multiples are not optimal for the continuous problem, so there is no
+  // certificate for them, and neither is there for other objectives than the
+  // cost.
+  const bool lexicographic = !options.objectives.empty();
+  const bool certify =
+      options.certificate && !options.granularity && !lexicographic;
+  const bool full_tableau = !bounds.empty() || options.granularity ||
+                            options.sensitivity || lexicographic;
+  if (options.network && !full_tableau) {
+    std::optional<BlockSolution> solution =
+        SolveBlockAsNetwork(input, demands, certify, stats, monitor);
+    if (solution) return solution;
+  }
+  const TraceSpan span("SolveBlock");
+  const auto measure = [&](PhaseStats SolveStats::*phase) {
+    return PhaseScope(stats ? &(stats->*phase) : nullptr);
+  };
   // Retrieve the list of resources referenced by the input problem. The order
   // of elements in this list will determine the column order in the tableau.
-  const std::vector<std::string_view> resources = Resources(input);
+  std::vector<std::string_view> resources;
+  {
+    const PhaseScope phase = measure(&SolveStats::resources);
+    resources = Resources(input, demands);
+  }
+  // A warm start which is still optimal only needs checking.
+  if (options.warm_start && !full_tableau) {
+    std::optional<BlockSolution> solution = SolveBlockFromBasis(
+        input, demands, resources,
+        BasisColumns(*options.warm_start, resources, input), options.threads,
+        certify, stats);
+    if (solution) {
+      if (monitor) monitor->Raise(solution->cost);
+      return solution;
+    }
+  }
+  const bool interior_point =
+      options.engine == Engine::kInteriorPoint ||
+      (options.engine == Engine::kAuto &&
+       std::ssize(input.recipes) >= kInteriorPointRecipes);
+  if (interior_point && !full_tableau) {
+    std::optional<BlockSolution> solution = SolveBlockByInteriorPoint(
+        input, demands, resources, options.threads, certify, options.pool,
+        stats, monitor);
+    if (solution) return solution;
+    if (monitor && monitor->Stopped()) return std::nullopt;
+  }
+  if (options.column_generation && !full_tableau) {
+    std::vector<int> recipes;
+    if (options.warm_start) {
+      // A warm start only seeds the set of recipes to start from.
+      for (int column :
+           BasisColumns(*options.warm_start, resources, input)) {
+        if (column >= std::ssize(resources)) {
+          recipes.push_back(column - resources.size());
+        }
+      }
+    }
+    std::optional<BlockSolution> solution =
+        SolveBlockLazily(input, demands, resources, recipes, {}, certify,
+                         options.pool, stats, monitor);
+    if (solution) return solution;
+  }
   // Convert the problem into a Simplex tableau for the dual problem and
-  // optimize it.
-  const std::optional<Table<Rational>> tableau =
-      Solve(BuildTableau(resources, input));
-  if (!tableau) return std::nullopt;
-  // Extract the optimal solution.
-  std::vector<Rational> uses = ExtractSolution(*tableau);
-  Rates rates = GetRates(input, uses);
+  // optimize it, starting from the slack basis unless a previous basis can be
+  // reused.
+  Table<Rational> tableau;
+  {
+    const TraceSpan span("BuildTableau");
+    const PhaseScope phase = measure(&SolveStats::build_tableau);
+    tableau = BuildTableau(resources, input, demands, options.pool);
+  }
+  const int n = resources.size();
+  const int r = input.recipes.size();
+  if (lexicographic) {
+    if (monitor) monitor->StopBounding();
+    for (int y = 0; y < r; y++) {
+      tableau[y].back() =
+          ObjectiveCost(options.objectives[0], input.recipes[y]);
+    }
+  }
+  if (stats) {
+    stats->rows = tableau.height();
+    stats->columns = tableau.width();
+  }
+  std::vector<int> basis(r);
+  for (int y = 0; y < r; y++) basis[y] = n + y;
+  {
+    const PhaseScope phase(stats ? &stats->pivot_loop : nullptr,
+                           stats ? &stats->bit_widths : nullptr);
+    if (options.warm_start) {
+      InstallBasis(tableau, basis,
+                   BasisColumns(*options.warm_start, resources, input));
+    }
+    if (!Solve(tableau, basis, bounds, stats, monitor)) return std::nullopt;
+    if (lexicographic && !options.granularity &&
+        !MinimizeInTurn(tableau, basis, bounds, input, options.objectives,
+                        stats, monitor)) {
+      return std::nullopt;
+    }
+  }
+  // The workers of the search time the nodes which they solve.
+  if (options.granularity &&
+      !BranchAndBound(tableau, basis, bounds, options, stats, monitor)) {
+    return std::nullopt;
+  }
+  BlockSolution solution;
+  {
+    const PhaseScope phase = measure(&SolveStats::extract_solution);
+    solution.uses = ExtractSolution(tableau);
+  }
+  if (lexicographic) {
+    solution.cost = 0;
+    for (int i = 0; i < r; i++) {
+      solution.cost += input.recipes[i].cost * solution.uses[i];
+    }
+  } else {
+    solution.cost = GetCost(tableau);
+  }
+  if (options.sensitivity && !options.granularity && !lexicographic) {
+    solution.sensitivity =
+        GetSensitivity(tableau, basis, bounds, resources, input, demands);
+  }
+  if (certify) {
+    solution.certificate =
+        GetCertificate(tableau, basis, origins, resources, input);
+  }
+  // Bounds are not part of the saved basis, as they are recomputed from the
+  // input.
+  for (int column : basis) {
+    if (column < 0) continue;
+    if (column < n) {
+      solution.basic_resources.push_back(resources[column]);
+    } else {
+      solution.basic_recipes.push_back(column - n);
+    }
+  }
+  return solution;
+}
+
+Solution MakeSolution(const Input& input, std::vector<Rational> uses,
+                      Rational cost, SolveStats* stats) {
+  Rates rates;
+  {
+    const TraceSpan span("GetRates");
+    const PhaseScope phase(stats ? &stats->get_rates : nullptr);
+    rates = GetRates(input, uses);
+  }
   return Solution{.input = &input,
                   .uses = std::move(uses),
                   .total = std::move(rates.total),
                   .net = std::move(rates.net),
-                  .cost = GetCost(*tableau)};
+                  .cost = cost,
+                  .sensitivity = std::nullopt};
+}
+
+}  // namespace
+
+Rational ObjectiveCost(const Objective& objective, const Recipe& recipe) {
+  switch (objective.kind) {
+    case Objective::Kind::kCost:
+      return recipe.cost;
+    case Objective::Kind::kMachines:
+      return 1;
+    case Objective::Kind::kRawResources: {
+      const auto primitive = [](const auto& item) { return item.second == 0; };
+      if (std::ranges::none_of(recipe.inputs, primitive)) return 0;
+      Rational total = 0;
+      for (const auto& [resource, quantity] : recipe.outputs) total += quantity;
+      return 60 * total / recipe.duration;
+    }
+    case Objective::Kind::kProduction: {
+      const auto i = recipe.outputs.find(objective.resource);
+      if (i == recipe.outputs.end()) return 0;
+      return 60 * i->second / recipe.duration;
+    }
+  }
+  return 0;
+}
+
+std::optional<Solution> Solve(const Input& input) {
+  return Solve(input, input.demands);
+}
+
+std::optional<Solution> Solve(const Input& input,
+                              std::span<const Demand> demands,
+                              const SolveOptions& options) {
+  const TraceSpan span("Solve");
+  SolveStats* const stats = options.stats;
+  if (options.stopped) *options.stopped = false;
+  if (options.certificate) *options.certificate = std::nullopt;
+  if (options.error) options.error->clear();
+  // Branch and bound and sensitivity analysis both work on the tableau of the
+  // whole problem, which the cache does not hold. Nor does it hold solutions
+  // for other objectives than the cost.
+  const bool whole_problem = options.granularity || options.sensitivity;
+  std::optional<CanonicalProblem> problem;
+  if (options.cache && !whole_problem && options.objectives.empty()) {
+    problem = Canonicalize(input, demands);
+    const std::optional<CachedSolution> cached =
+        options.cache->Lookup(*problem);
+    if (cached) {
+      const int r = input.recipes.size();
+      std::vector<Rational> uses(r);
+      for (int k = 0; k < r; k++) uses[problem->order[k]] = cached->uses[k];
+      if (stats) stats->cached = true;
+      return MakeSolution(input, std::move(uses), cached->cost, stats);
+    }
+  }
+  {
+    const TraceSpan span("Verify");
+    if (!Verify(input, demands, options.error)) return std::nullopt;
+  }
+  std::vector<Block> blocks;
+  {
+    const PhaseScope phase(stats ? &stats->decompose : nullptr);
+    if (options.decompose && !whole_problem) {
+      blocks = Decompose(input, demands);
+    } else {
+      Block& block = blocks.emplace_back();
+      block.recipes.resize(input.recipes.size());
+      std::iota(block.recipes.begin(), block.recipes.end(), 0);
+      block.demands.assign(demands.begin(), demands.end());
+    }
+  }
+  const int r = input.recipes.size();
+  const int num_blocks = blocks.size();
+  // Each block is solved on its own tableau, and each block is optimal on its
+  // own, so the combination of the blocks is optimal for the whole problem.
+  std::vector<std::optional<BlockSolution>> solutions(num_blocks);
+  std::vector<SolveStats> block_stats(stats ? num_blocks : 0);
+  // Solves which cannot be stopped and do not report progress are not
+  // monitored, which saves taking its lock on every pivot.
+  std::optional<Monitor> monitored;
+  if (options.stop_token.stop_possible() || options.deadline ||
+      options.progress) {
+    monitored.emplace(options);
+  }
+  Monitor* const monitor = monitored ? &*monitored : nullptr;
+  ParallelFor(
+      num_blocks,
+      [&](int b) {
+        SolveStats* const s = stats ? &block_stats[b] : nullptr;
+        // A block which holds every recipe is solved without copying them.
+        if (std::ssize(blocks[b].recipes) == r) {
+          solutions[b] =
+              SolveBlock(input, blocks[b].demands, options, s, monitor);
+          return;
+        }
+        Input block;
+        block.limits = input.limits;
+        block.recipes.reserve(blocks[b].recipes.size());
+        for (int i : blocks[b].recipes) {
+          block.recipes.push_back(input.recipes[i]);
+        }
+        solutions[b] =
+            SolveBlock(block, blocks[b].demands, options, s, monitor);
+      },
+      options.threads);
+  if (options.stopped && monitor) *options.stopped = monitor->stopped();
+  if (stats) {
+    stats->blocks = num_blocks;
+    for (const SolveStats& s : block_stats) *stats += s;
+  }
+  // Merge the blocks, which share no recipes and no resources.
+  std::vector<Rational> uses(r);
+  Rational cost = 0;
+  std::vector<std::string_view> basic_resources;
+  std::vector<int> basic_recipes;
+  for (int b = 0; b < num_blocks; b++) {
+    if (!solutions[b]) return std::nullopt;
+    const BlockSolution& solution = *solutions[b];
+    const std::vector<int>& recipes = blocks[b].recipes;
+    for (std::size_t k = 0; k < recipes.size(); k++) {
+      uses[recipes[k]] = solution.uses[k];
+    }
+    cost += solution.cost;
+    basic_resources.insert(basic_resources.end(),
+                           solution.basic_resources.begin(),
+                           solution.basic_resources.end());
+    for (int k : solution.basic_recipes) basic_recipes.push_back(recipes[k]);
+  }
+  if (options.final_basis) {
+    Basis& basis = *options.final_basis;
+    basis = {};
+    for (std::string_view resource : basic_resources) {
+      basis.resources.push_back(std::string(resource));
+    }
+    for (int i : basic_recipes) {
+      basis.recipes.push_back(RecipeKey(input.recipes[i]));
+    }
+  }
+  // Each resource and each limit belongs to a single block.
+  const auto has_certificate = [](const std::optional<BlockSolution>& s) {
+    return s->certificate.has_value();
+  };
+  if (options.certificate && std::ranges::all_of(solutions, has_certificate)) {
+    Certificate& certificate = options.certificate->emplace();
+    for (int b = 0; b < num_blocks; b++) {
+      const Certificate& block = *solutions[b]->certificate;
+      certificate.prices.insert(block.prices.begin(), block.prices.end());
+      for (std::size_t k = 0; k < block.recipe_limits.size(); k++) {
+        if (block.recipe_limits[k] == 0) continue;
+        certificate.recipe_limits.resize(r);
+        certificate.recipe_limits[blocks[b].recipes[k]] =
+            block.recipe_limits[k];
+      }
+      for (std::size_t l = 0; l < block.resource_limits.size(); l++) {
+        if (block.resource_limits[l] == 0) continue;
+        certificate.resource_limits.resize(input.limits.size());
+        certificate.resource_limits[l] = block.resource_limits[l];
+      }
+    }
+  }
+  if (problem) {
+    CachedSolution cached{.uses = {}, .cost = cost};
+    cached.uses.reserve(uses.size());
+    for (int i : problem->order) cached.uses.push_back(uses[i]);
+    options.cache->Insert(*problem, cached);
+  }
+  Solution solution = MakeSolution(input, std::move(uses), cost, stats);
+  // Without decomposition, there is a single block holding every recipe.
+  if (whole_problem) {
+    solution.sensitivity = std::move(solutions[0]->sensitivity);
+  }
+  return solution;
+}
+
+std::vector<Breakpoint> Sweep(const Input& input,
+                              std::span<const Demand> base,
+                              std::span<const Demand> direction,
+                              const Rational& start, const Rational& end,
+                              SolveStats* stats) {
+  assert(start <= end);
+  const TraceSpan span("Sweep");
+  std::vector<Demand> demands(base.begin(), base.end());
+  for (const auto& [resource, units_per_minute] : direction) {
+    demands.push_back({resource, start * units_per_minute});
+  }
+  if (!Verify(input, demands)) return {};
+  // The direction is part of the demands, so its resources have columns even
+  // when start is zero.
+  const std::vector<std::string_view> resources = Resources(input, demands);
+  const std::vector<Bound> bounds = GetBounds(input);
+  const int n = resources.size();
+  const int r = input.recipes.size();
+  std::vector<int> basis(r);
+  for (int y = 0; y < r; y++) basis[y] = n + y;
+  Table<Rational> tableau = BuildTableau(resources, input, demands);
+  if (stats) {
+    stats->rows = tableau.height();
+    stats->columns = tableau.width();
+  }
+  if (!Solve(tableau, basis, bounds, stats, nullptr)) return {};
+  const std::span<Rational> cost_row = tableau[r];
+  // The entry of a row in a column, which for a bound is minus the weighted sum
+  // of the slack columns of its recipes, as in GetColumn.
+  const auto entry = [&](std::span<const Rational> row, int column) {
+    if (column >= 0) return row[column];
+    Rational x = 0;
+    for (const auto& [i, weight] : bounds[-1 - column].terms) {
+      x -= weight * row[n + i];
+    }
+    return x;
+  };
+  // The demands only appear in the initial cost row, so the cost row at t + s
+  // is the cost row at t plus s times the slope, which is the cost row of the
+  // direction alone, expressed in terms of the current basis like the others.
+  std::vector<Rational> slope(tableau.width());
+  for (const auto& [resource, units_per_minute] : direction) {
+    slope[ResourceColumn(resources, resource)] -= units_per_minute / 60;
+  }
+  for (int y = 0; y < r; y++) {
+    const Rational x = entry(slope, basis[y]);
+    if (x != 0) AddMultiple(slope, tableau[y], -x);
+  }
+  Rational t = start;
+  std::vector<Breakpoint> breakpoints;
+  const auto add_breakpoint = [&] {
+    if (!breakpoints.empty() && breakpoints.back().t == t) return;
+    Solution solution =
+        MakeSolution(input, ExtractSolution(tableau), GetCost(tableau), stats);
+    // The basis can change without the uses changing direction, in which case
+    // the previous breakpoint lies on the line through its neighbours.
+    if (breakpoints.size() >= 2) {
+      const Breakpoint& a = breakpoints[breakpoints.size() - 2];
+      const Breakpoint& b = breakpoints.back();
+      bool collinear = true;
+      for (int i = 0; i < r && collinear; i++) {
+        collinear = (b.solution.uses[i] - a.solution.uses[i]) * (t - b.t) ==
+                    (solution.uses[i] - b.solution.uses[i]) * (b.t - a.t);
+      }
+      if (collinear) breakpoints.pop_back();
+    }
+    breakpoints.push_back({.t = t, .solution = std::move(solution)});
+  };
+  add_breakpoint();
+  while (t < end) {
+    // The basis stays optimal until the entry of some column in the cost row
+    // falls to zero, and that column then enters the basis. Ties go to the
+    // first such column.
+    std::optional<int> column;
+    Rational step = end - t;
+    const auto consider = [&](int x, const Rational& cost,
+                              const Rational& rate) {
+      if (rate >= 0) return;
+      const Rational limit = cost / -rate;
+      if (limit < step) {
+        column = x;
+        step = limit;
+      }
+    };
+    for (int x = 0; x < n + r; x++) consider(x, cost_row[x], slope[x]);
+    for (int k = 0; k < std::ssize(bounds); k++) {
+      consider(-1 - k, bounds[k].limit + entry(cost_row, -1 - k),
+               entry(slope, -1 - k));
+    }
+    AddMultiple(cost_row, slope, step);
+    t += step;
+    if (!column) break;
+    add_breakpoint();
+    const std::vector<Rational> pivot_column =
+        GetColumn(tableau, bounds, *column);
+    // If nothing limits the entering column, the dual problem is unbounded
+    // past t, so the demands cannot be met.
+    const std::optional<int> row = PivotRow(tableau, pivot_column);
+    if (!row) return breakpoints;
+    const Rational x = entry(slope, *column);
+    Pivot(tableau, *row, pivot_column);
+    basis[*row] = *column;
+    AddMultiple(slope, tableau[*row], -x);
+    if (stats) stats->pivots++;
+  }
+  add_breakpoint();
+  return breakpoints;
 }
 
 }  // namespace satisfactory
@@ -3,12 +3,203 @@
 
 #include "data.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <vector>
 
 namespace satisfactory {
 
+// Solves for the top-level demands of the input.
 std::optional<Solution> Solve(const Input& input);
 
+struct Basis;
+struct Certificate;
+class SolutionCache;
+struct SolveStats;
+class TablePool;
+
+// The progress of a solve, as reported to SolveOptions::progress.
+struct Progress {
+  // The pivots so far, over every tableau of the solve.
+  std::int64_t pivots;
+  // A lower bound on the optimal cost, which rises towards it as the tableaus
+  // are pivoted. It stops rising with column generation, a granularity or
+  // objectives, as their tableaus do not bound the cost of the whole problem.
+  Rational bound;
+};
+
+// How the optimal basis of a block is found when it cannot be solved as a
+// network.
+enum class Engine {
+  // The interior-point method for blocks with hundreds of recipes or more,
+  // where the simplex algorithm needs many pivots on a huge tableau, and the
+  // simplex algorithm otherwise.
+  kAuto,
+  kSimplex,
+  // The interior-point method (see SolveInterior), followed by crossover: the
+  // basis which it identifies seeds column generation, which confirms it in
+  // exact arithmetic and corrects it if rounding errors misidentified any of
+  // its variables. This gives the same optimal cost as the simplex algorithm.
+  // Its factorizations run on up to SolveOptions::threads threads.
+  // Problems with bounds, a granularity or sensitivity analysis always use the
+  // simplex algorithm, as column generation does not support them.
+  kInteriorPoint,
+};
+
+// A quantity which a solution can minimize: the sum over the recipes of a cost
+// for each use.
+struct Objective {
+  enum class Kind {
+    // The cost of the recipe, as given in the input.
+    kCost,
+    // One for each use, so that the sum is the number of machines running at
+    // full speed.
+    kMachines,
+    // The units/min of the outputs of a recipe with a primitive input, such as
+    // (ResourceNode), which is the rate at which it extracts raw resources.
+    kRawResources,
+    // The units/min of the resource which the recipe produces, regardless of
+    // how much of it the recipe consumes.
+    kProduction,
+  };
+  Kind kind = Kind::kCost;
+  // The resource produced, for kProduction.
+  std::string resource = {};
+};
+
+// Returns the cost of a use of the recipe under the objective, which is never
+// negative.
+Rational ObjectiveCost(const Objective& objective, const Recipe& recipe);
+
+struct SolveOptions {
+  // If set, solutions are looked up in this cache before solving and are added
+  // to it afterwards. A cached solution may have been computed for the same
+  // recipes in a different order, in which case it is an equally optimal but
+  // not necessarily identical solution.
+  SolutionCache* cache = nullptr;
+  // If set, the simplex algorithm starts from this basis when it is still
+  // feasible for the problem, rather than from the slack basis. Blocks for
+  // which it is still optimal are solved from it without a tableau, by exact
+  // multi-modular arithmetic (see SolveModular), unless they have bounds.
+  const Basis* warm_start = nullptr;
+  // If set, receives the optimal basis. This is left untouched if the solution
+  // is served from the cache.
+  Basis* final_basis = nullptr;
+  // If set, receives the values of the dual problem which prove the solution
+  // optimal (see CheckCertificate), or std::nullopt if there are none: for
+  // solutions served from the cache, for whole multiples of a granularity, and
+  // for solves which fail.
+  std::optional<Certificate>* certificate = nullptr;
+  // If set, receives timings and other measurements of the solve.
+  SolveStats* stats = nullptr;
+  // If set, tableaus are allocated from this pool, which lets successive
+  // solves reuse the memory of earlier tableaus. SolveScenarios provides one
+  // for the scenarios which do not set it.
+  TablePool* pool = nullptr;
+  // Whether to split the problem into independent blocks (see Decompose), which
+  // is usually faster. This gives the same solution as solving the problem on
+  // a single tableau, even when several are optimal, as long as the blocks are
+  // solved the same way: a block which is a network may be solved without
+  // a tableau (see network), and a large problem by the interior-point method
+  // while its blocks are not, which may break ties differently.
+  bool decompose = true;
+  // Whether to solve blocks which are generalized networks, where each recipe
+  // has a single input and a single output, without a tableau (see
+  // SolveNetwork). This gives the same optimal cost, and is much faster.
+  bool network = true;
+  // Whether to solve by column generation, starting from a few recipes and only
+  // adding the others once they would reduce the cost. This gives the same
+  // optimal cost, though not necessarily the same solution when several are
+  // optimal, and is faster when most recipes are never worth using, as is
+  // typical with many alternate recipes. A warm start only seeds the set of
+  // recipes to start from.
+  bool column_generation = false;
+  Engine engine = Engine::kAuto;
+  // If non-empty, the objectives to minimize in turn instead of the cost:
+  // the solution minimizes the first, then the second among the solutions
+  // which minimize the first, and so on. Once the tableau is optimal for one
+  // objective, the solutions which are optimal for it are fixed and the
+  // tableau is pivoted from there for the next, which is little more work than
+  // a single solve. The solution cache, networks, warm starts without
+  // a tableau, column generation and the interior-point method only minimize
+  // the cost, so they are not used, and there is no certificate or
+  // sensitivity analysis. With a granularity, only the first objective is
+  // minimized. Solution::cost remains the cost of the recipes.
+  std::vector<Objective> objectives = {};
+  // If set, the use of each recipe must be a whole multiple of this: 1 gives
+  // whole machines running at full speed, while 1/4 also allows machines to be
+  // underclocked to 25%, 50% or 75%. The cheapest such solution is found by
+  // branch and bound, which can take much longer than the continuous solve.
+  // The problem is not decomposed, so that the search explores a single tree,
+  // and the solution cache is not used. With several threads, the optimal
+  // cost is the same but the solution may vary from run to run when several
+  // are optimal.
+  std::optional<Rational> granularity = std::nullopt;
+  // If positive, the branch-and-bound search stops once it has solved this
+  // many nodes, giving the cheapest solution found so far rather than the
+  // cheapest possible, or none if it has not found one yet.
+  std::int64_t max_nodes = 0;
+  // Whether to fill in Solution::sensitivity. This solves the whole problem on
+  // a single tableau, without decomposing it, solving it as a network or by
+  // column generation, or using the solution cache. It is ignored with a
+  // granularity, as the final tableau of the branch-and-bound search describes
+  // the bounds of a single branch rather than the problem.
+  bool sensitivity = false;
+  // The number of threads used to solve the independent blocks of a problem,
+  // or to explore the branch-and-bound tree with a granularity. A non-positive
+  // value selects one thread per hardware thread.
+  int threads = 1;
+  // If a stop is requested or the deadline passes, the solve stops as soon as
+  // possible, between two pivots. It then fails, since the simplex algorithm
+  // on the dual problem has no feasible solution to the problem until it is
+  // optimal, except with a granularity, where it gives the cheapest solution
+  // found so far.
+  std::stop_token stop_token = {};
+  std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt;
+  // If set, receives whether the solve was stopped early, in which case its
+  // solution, if any, is not known to be optimal.
+  bool* stopped = nullptr;
+  // If set, receives why the demands cannot be met when some resource which
+  // they need has no recipe, such as "no recipe for Coal", rather than this
+  // being reported on stderr. It is cleared otherwise.
+  std::string* error = nullptr;
+  // If set, called every few pivots. Calls are never concurrent, but may come
+  // from any of the threads solving the problem, and should return quickly.
+  std::function<void(const Progress&)> progress = nullptr;
+};
+
+// Solves for the given demands using the recipes of the input. Returns
+// std::nullopt if the demands cannot be met.
+std::optional<Solution> Solve(const Input& input,
+                              std::span<const Demand> demands,
+                              const SolveOptions& options = {});
+
+// The optimal solution at one value of the parameter of a sweep.
+struct Breakpoint {
+  Rational t;
+  Solution solution;
+};
+
+// Solves for the demands base + t * direction at every t from start to end,
+// which must be at least start. The optimal uses and cost are piecewise linear
+// in t, so the result is the solution at start, at each t where the optimal
+// uses change direction, and at end, and the solution at any t in between is
+// the linear interpolation of the breakpoints around it. Rather than solving at
+// each breakpoint, the parametric simplex algorithm solves once at start and
+// then carries the tableau along as t grows, pivoting whenever the basis stops
+// being optimal. If the demands cannot be met past some t, the last breakpoint
+// is at that t, and if they cannot be met at start, the result is empty.
+std::vector<Breakpoint> Sweep(const Input& input,
+                              std::span<const Demand> base,
+                              std::span<const Demand> direction,
+                              const Rational& start, const Rational& end,
+                              SolveStats* stats = nullptr);
+
 }  // namespace satisfactory
 
 #endif  // SOLVER_HPP_
@@ -0,0 +1,388 @@
+// Benchmarks for the integer kernels, rational arithmetic, the parser and the
+// solver, including the solver on generated problems of increasing size.
+//
+// Usage: solver_bench [--filter=<substring>] [--min-time=<seconds>]
+//                     [--output=<file>] [--baseline=<file>]
+//                     [--threshold=<percent>]
+//        solver_bench [--threshold=<percent>] --compare <baseline> <current>
+//
+// Results are written as JSON with one benchmark per line, so that they can be
+// checked in and diffed. Given a baseline, benchmarks which are slower than the
+// baseline by more than the threshold are reported as regressions and the exit
+// status is non-zero.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "generator.hpp"
+#include "integer.hpp"
+#include "module.hpp"
+#include "parser.hpp"
+#include "rational.hpp"
+#include "solver.hpp"
+
+namespace satisfactory {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Each benchmark is timed repeatedly, and the median of these runs is reported.
+constexpr int kRepetitions = 5;
+// The number of distinct operands cycled through by the arithmetic
+// benchmarks, which prevents the compiler from hoisting the work out of the
+// benchmark loop.
+constexpr int kNumOperands = 256;
+
+// Prevents the compiler from discarding the computation of a value.
+template <typename T>
+void DoNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Benchmark {
+  std::string name;
+  // Runs the benchmarked operation the given number of times.
+  std::function<void(std::int64_t)> run;
+};
+
+struct Result {
+  std::string name;
+  std::int64_t iterations;
+  double ns_per_iteration;
+};
+
+struct Options {
+  std::string filter;
+  double min_time = 0.5;
+  std::string output;
+  std::string baseline;
+  double threshold = 10;
+  // Compare mode: the baseline and current results files.
+  std::vector<std::string> compare;
+};
+
+[[noreturn]] void Usage() {
+  std::cerr << "Usage: solver_bench [--filter=<substring>] "
+               "[--min-time=<seconds>]\n"
+               "                    [--output=<file>] [--baseline=<file>]\n"
+               "                    [--threshold=<percent>]\n"
+               "       solver_bench [--threshold=<percent>] "
+               "--compare <baseline> <current>\n";
+  std::exit(1);
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg = argv[i];
+    const std::string value(arg.substr(arg.find('=') + 1));
+    if (arg.starts_with("--filter=")) {
+      options.filter = value;
+    } else if (arg.starts_with("--min-time=")) {
+      options.min_time = std::atof(value.c_str());
+    } else if (arg.starts_with("--output=")) {
+      options.output = value;
+    } else if (arg.starts_with("--baseline=")) {
+      options.baseline = value;
+    } else if (arg.starts_with("--threshold=")) {
+      options.threshold = std::atof(value.c_str());
+    } else if (arg == "--compare" && i + 2 < argc) {
+      options.compare = {argv[i + 1], argv[i + 2]};
+      i += 2;
+    } else {
+      Usage();
+    }
+  }
+  return options;
+}
+
+std::vector<uint128> RandomIntegers(std::mt19937_64& random, int bits) {
+  std::vector<uint128> values;
+  for (int i = 0; i < kNumOperands; i++) {
+    uint128 value = 0;
+    for (int b = 0; b < bits; b += 64) value = (value << 64) + random();
+    value = value >> (128 - bits);
+    values.push_back(value == 0 ? uint128(1) : value);
+  }
+  return values;
+}
+
+// Fractions of the size which typically appear in a tableau.
+std::vector<Rational> RandomRationals(std::mt19937_64& random) {
+  std::uniform_int_distribution<std::int64_t> numerator(-(1 << 20), 1 << 20);
+  std::uniform_int_distribution<std::int64_t> denominator(1, 1 << 12);
+  std::vector<Rational> values;
+  for (int i = 0; i < kNumOperands; i++) {
+    values.push_back(Rational(numerator(random), denominator(random)));
+  }
+  return values;
+}
+
+std::string ReadFile(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  if (!file) {
+    std::cerr << "Failed to read " << path.string() << '\n';
+    std::exit(1);
+  }
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Applies a binary operation to successive pairs of operands.
+template <typename T, typename F>
+std::function<void(std::int64_t)> BinaryBenchmark(std::vector<T> a,
+                                                  std::vector<T> b, F f) {
+  return [a = std::move(a), b = std::move(b), f](std::int64_t iterations) {
+    for (std::int64_t i = 0; i < iterations; i++) {
+      const int k = i % kNumOperands;
+      DoNotOptimize(f(a[k], b[(k + 1) % kNumOperands]));
+    }
+  };
+}
+
+std::vector<Benchmark> MakeBenchmarks(ModuleCache& modules) {
+  std::mt19937_64 random(0x5A715FAC);
+  std::vector<Benchmark> benchmarks;
+  // Integer kernels.
+  const std::vector<uint128> small = RandomIntegers(random, 48);
+  const std::vector<uint128> large = RandomIntegers(random, 96);
+  benchmarks.push_back(
+      {"uint128/Multiply",
+       BinaryBenchmark(small, small, [](uint128 a, uint128 b) {
+         return a * b;
+       })});
+  benchmarks.push_back(
+      {"uint128/DivMod",
+       BinaryBenchmark(large, small, [](uint128 a, uint128 b) {
+         return a / b;
+       })});
+  benchmarks.push_back(
+      {"uint128/gcd", BinaryBenchmark(large, large, [](uint128 a, uint128 b) {
+         return gcd(a, b);
+       })});
+  // Rational arithmetic.
+  const std::vector<Rational> rationals = RandomRationals(random);
+  benchmarks.push_back(
+      {"Rational/Add",
+       BinaryBenchmark(rationals, rationals, [](Rational a, Rational b) {
+         return a + b;
+       })});
+  benchmarks.push_back(
+      {"Rational/Multiply",
+       BinaryBenchmark(rationals, rationals, [](Rational a, Rational b) {
+         return a * b;
+       })});
+  benchmarks.push_back(
+      {"Rational/Divide",
+       BinaryBenchmark(rationals, rationals, [](Rational a, Rational b) {
+         return b == 0 ? a : a / b;
+       })});
+  // The parser, on each file on its own: imports are not followed.
+  const std::filesystem::path source_dir = SOURCE_DIR;
+  for (const char* filename :
+       {"recipes.txt", "building.txt", "objectives.txt"}) {
+    benchmarks.push_back(
+        {std::string("ParseInput/") + filename,
+         [source = ReadFile(source_dir / filename)](std::int64_t iterations) {
+           for (std::int64_t i = 0; i < iterations; i++) {
+             const std::optional<Input> input = ParseInput(source);
+             DoNotOptimize(input->recipes.data());
+           }
+         }});
+  }
+  // The solver, on every scenario.
+  const Input& objectives = *modules.Load(source_dir / "objectives.txt");
+  for (const Scenario& scenario : objectives.scenarios) {
+    benchmarks.push_back(
+        {"Solve/" + std::string(scenario.name),
+         [&objectives, &scenario](std::int64_t iterations) {
+           for (std::int64_t i = 0; i < iterations; i++) {
+             DoNotOptimize(Solve(objectives, scenario.demands));
+           }
+         }});
+  }
+  const Input& building = *modules.Load(source_dir / "building.txt");
+  benchmarks.push_back({"Solve/building.txt", [&building](std::int64_t n) {
+                          for (std::int64_t i = 0; i < n; i++) {
+                            DoNotOptimize(Solve(building));
+                          }
+                        }});
+  struct Generated {
+    std::string source;
+    Input input;
+  };
+  const auto add_generated = [&](std::string name,
+                                 const GeneratorOptions& generator,
+                                 const SolveOptions& options) {
+    auto generated = std::make_shared<Generated>();
+    generated->source = GenerateInput(generator);
+    generated->input = *ParseInput(generated->source, "generated");
+    benchmarks.push_back(
+        {std::move(name), [generated, options](std::int64_t iterations) {
+           for (std::int64_t i = 0; i < iterations; i++) {
+             DoNotOptimize(Solve(generated->input, generated->input.demands,
+                                 options));
+           }
+         }});
+  };
+  // Scaling curves, on generated problems of increasing size.
+  for (int resources : {50, 100, 200, 400}) {
+    add_generated("Solve/generated/" + std::to_string(resources),
+                  {.resources = resources}, {});
+  }
+  // A large catalog of alternate recipes, most of which are never used, with
+  // and without column generation.
+  for (bool column_generation : {false, true}) {
+    add_generated(column_generation ? "Solve/alternates/column_generation"
+                                    : "Solve/alternates/full",
+                  {.resources = 50, .alternates = 6},
+                  {.column_generation = column_generation});
+  }
+  // A catalog of thousands of recipes, solved by the interior-point method.
+  add_generated("Solve/catalog/interior_point",
+                {.resources = 400, .alternates = 10},
+                {.engine = Engine::kInteriorPoint});
+  // A generalized network, in which every recipe has a single input, with and
+  // without the network fast path.
+  for (bool network : {true, false}) {
+    add_generated(network ? "Solve/chain/network" : "Solve/chain/tableau",
+                  {.resources = 100, .max_inputs = 1, .byproducts = 0},
+                  {.network = network});
+  }
+  return benchmarks;
+}
+
+double Seconds(Clock::duration duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
+Result Run(const Benchmark& benchmark, double min_time) {
+  // Find an iteration count which takes a measurable fraction of the target
+  // time for each repetition.
+  const double target = min_time / kRepetitions;
+  std::int64_t iterations = 1;
+  while (true) {
+    const Clock::time_point start = Clock::now();
+    benchmark.run(iterations);
+    const double elapsed = Seconds(Clock::now() - start);
+    if (elapsed >= target) break;
+    const double scale = elapsed > 0 ? 1.4 * target / elapsed : 10;
+    iterations = std::max<std::int64_t>(
+        iterations + 1, iterations * std::min(scale, 10.0));
+  }
+  std::vector<double> times;
+  for (int i = 0; i < kRepetitions; i++) {
+    const Clock::time_point start = Clock::now();
+    benchmark.run(iterations);
+    times.push_back(Seconds(Clock::now() - start) * 1e9 / iterations);
+  }
+  std::ranges::sort(times);
+  return {.name = benchmark.name,
+          .iterations = iterations,
+          .ns_per_iteration = times[kRepetitions / 2]};
+}
+
+void WriteResults(std::ostream& output, const std::vector<Result>& results) {
+  output << "{\"benchmarks\": [\n";
+  for (std::size_t i = 0; i < results.size(); i++) {
+    // Benchmark names never contain quotes or backslashes.
+    output << "{\"name\": \"" << results[i].name
+           << "\", \"iterations\": " << results[i].iterations
+           << ", \"ns_per_iteration\": " << std::fixed << std::setprecision(1)
+           << results[i].ns_per_iteration << '}'
+           << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  output << "]}\n";
+}
+
+// Reads results in the format written by WriteResults.
+std::vector<Result> ReadResults(const std::filesystem::path& path) {
+  static const std::regex line(
+      R"re(\{"name": "([^"]*)", "iterations": (\d+), )re"
+      R"re("ns_per_iteration": ([0-9.]+)\})re");
+  std::istringstream input(ReadFile(path));
+  std::vector<Result> results;
+  std::string text;
+  while (std::getline(input, text)) {
+    std::smatch match;
+    if (!std::regex_search(text, match, line)) continue;
+    results.push_back({.name = match[1],
+                       .iterations = std::stoll(match[2]),
+                       .ns_per_iteration = std::stod(match[3])});
+  }
+  return results;
+}
+
+// Prints the change in each benchmark and returns false if any have regressed
+// by more than the threshold percentage.
+bool Compare(const std::vector<Result>& baseline,
+             const std::vector<Result>& current, double threshold) {
+  std::map<std::string, double> before;
+  for (const Result& result : baseline) {
+    before[result.name] = result.ns_per_iteration;
+  }
+  bool ok = true;
+  std::cout << std::fixed << std::setprecision(1);
+  for (const Result& result : current) {
+    const auto i = before.find(result.name);
+    if (i == before.end()) continue;
+    const double change = 100 * (result.ns_per_iteration / i->second - 1);
+    const bool regressed = change > threshold;
+    ok = ok && !regressed;
+    std::cout << std::left << std::setw(72) << result.name << std::right
+              << std::setw(14) << i->second << std::setw(14)
+              << result.ns_per_iteration << std::setw(9) << std::showpos
+              << change << '%' << std::noshowpos
+              << (regressed ? "  REGRESSION" : "") << '\n';
+  }
+  return ok;
+}
+
+}  // namespace
+}  // namespace satisfactory
+
+int main(int argc, char* argv[]) {
+  using namespace satisfactory;
+  const Options options = ParseOptions(argc, argv);
+  if (!options.compare.empty()) {
+    return Compare(ReadResults(options.compare[0]),
+                   ReadResults(options.compare[1]), options.threshold)
+               ? 0
+               : 1;
+  }
+  ModuleCache modules;
+  std::vector<Result> results;
+  for (const Benchmark& benchmark : MakeBenchmarks(modules)) {
+    if (benchmark.name.find(options.filter) == std::string::npos) continue;
+    results.push_back(Run(benchmark, options.min_time));
+    std::cerr << std::left << std::setw(72) << benchmark.name << std::right
+              << std::fixed << std::setprecision(1) << std::setw(14)
+              << results.back().ns_per_iteration << " ns\n";
+  }
+  if (options.output.empty()) {
+    WriteResults(std::cout, results);
+  } else {
+    std::ofstream output(options.output);
+    WriteResults(output, results);
+  }
+  if (options.baseline.empty()) return 0;
+  return Compare(ReadResults(options.baseline), results, options.threshold)
+             ? 0
+             : 1;
+}
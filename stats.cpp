@@ -0,0 +1,141 @@
+#include "stats.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace satisfactory {
+namespace {
+
+// Histogram buckets are printed in ranges of this many bits.
+constexpr int kBucketBits = 8;
+
+void PrintPhase(std::ostream& output, std::string_view name,
+                const PhaseStats& phase) {
+  output << "  " << std::left << std::setw(18) << name << std::right << phase
+         << '\n';
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& output, const PhaseStats& phase) {
+  const std::ios_base::fmtflags flags = output.flags();
+  const std::streamsize precision = output.precision();
+  const double ms =
+      std::chrono::duration<double, std::milli>(phase.time).count();
+  output << std::fixed << std::setprecision(3) << std::setw(10) << ms << " ms";
+  if (kCountAllocations) {
+    const AllocationCounts& a = phase.allocations;
+    output << std::setw(10) << a.allocations << " allocs" << std::setw(12)
+           << a.bytes << " bytes" << std::setw(12) << a.peak << " peak";
+  }
+  output.flags(flags);
+  output.precision(precision);
+  return output;
+}
+
+std::int64_t SolveStats::CountBitWidths(std::span<const Rational> values) {
+  std::int64_t nonzeros = 0;
+  for (const Rational& value : values) {
+    if (value == 0) continue;
+    nonzeros++;
+    numerator_bits[bit_width(value.numerator())]++;
+    denominator_bits[bit_width(value.denominator())]++;
+  }
+  return nonzeros;
+}
+
+SolveStats& SolveStats::operator+=(const SolveStats& other) {
+  for (auto phase : {&SolveStats::decompose, &SolveStats::resources,
+                     &SolveStats::interior_point, &SolveStats::build_tableau,
+                     &SolveStats::pivot_loop, &SolveStats::bit_widths,
+                     &SolveStats::extract_solution, &SolveStats::get_rates,
+                     &SolveStats::print}) {
+    PhaseStats& a = this->*phase;
+    const PhaseStats& b = other.*phase;
+    a.time += b.time;
+    a.allocations.allocations += b.allocations.allocations;
+    a.allocations.bytes += b.allocations.bytes;
+    a.allocations.peak = std::max(a.allocations.peak, b.allocations.peak);
+  }
+  network_blocks += other.network_blocks;
+  cached = cached || other.cached;
+  pivots += other.pivots;
+  degenerate_pivots += other.degenerate_pivots;
+  rows += other.rows;
+  columns += other.columns;
+  initial_nonzeros += other.initial_nonzeros;
+  final_nonzeros += other.final_nonzeros;
+  pricing_rounds += other.pricing_rounds;
+  active_recipes += other.active_recipes;
+  interior_point_blocks += other.interior_point_blocks;
+  interior_point_iterations += other.interior_point_iterations;
+  basis_blocks += other.basis_blocks;
+  primes += other.primes;
+  nodes += other.nodes;
+  for (std::size_t b = 0; b < numerator_bits.size(); b++) {
+    numerator_bits[b] += other.numerator_bits[b];
+    denominator_bits[b] += other.denominator_bits[b];
+  }
+  return *this;
+}
+
+std::ostream& operator<<(std::ostream& output, const SolveStats& stats) {
+  const std::ios_base::fmtflags flags = output.flags();
+  output << "Solve statistics" << (stats.cached ? " (cached)" : "") << ":\n";
+  PrintPhase(output, "Decompose", stats.decompose);
+  PrintPhase(output, "Resources", stats.resources);
+  PrintPhase(output, "InteriorPoint", stats.interior_point);
+  PrintPhase(output, "BuildTableau", stats.build_tableau);
+  PrintPhase(output, "Pivot loop", stats.pivot_loop);
+  PrintPhase(output, "BitWidths", stats.bit_widths);
+  PrintPhase(output, "ExtractSolution", stats.extract_solution);
+  PrintPhase(output, "GetRates", stats.get_rates);
+  PrintPhase(output, "Print", stats.print);
+  output << "  Blocks: " << stats.blocks << " (" << stats.network_blocks
+         << " solved as networks)\n";
+  output << "  Pivots: " << stats.pivots << " (" << stats.degenerate_pivots
+         << " degenerate)\n"
+         << "  Tableau: " << stats.rows << " x " << stats.columns << ", "
+         << stats.initial_nonzeros << " non-zero initially, "
+         << stats.final_nonzeros << " when optimal\n";
+  if (stats.pricing_rounds > 0) {
+    output << "  Column generation: " << stats.pricing_rounds
+           << " pricing rounds, " << stats.active_recipes
+           << " recipes active\n";
+  }
+  if (stats.interior_point_blocks > 0) {
+    output << "  Interior point: " << stats.interior_point_blocks
+           << " blocks, " << stats.interior_point_iterations
+           << " iterations\n";
+  }
+  if (stats.basis_blocks > 0) {
+    output << "  Warm start: " << stats.basis_blocks
+           << " blocks solved from the basis, modulo " << stats.primes
+           << " primes\n";
+  }
+  if (stats.nodes > 0) {
+    output << "  Branch and bound: " << stats.nodes << " nodes\n";
+  }
+  int widest = 0;
+  for (int b = 0; b < std::ssize(stats.numerator_bits); b++) {
+    if (stats.numerator_bits[b] || stats.denominator_bits[b]) widest = b;
+  }
+  output << "  Operand bit widths (numerators, denominators):\n";
+  for (int low = 1; low <= widest; low += kBucketBits) {
+    std::int64_t numerators = 0, denominators = 0;
+    for (int b = low; b < low + kBucketBits; b++) {
+      numerators += stats.numerator_bits[b];
+      denominators += stats.denominator_bits[b];
+    }
+    if (numerators == 0 && denominators == 0) continue;
+    output << "    " << std::setw(3) << low << '-' << std::left << std::setw(3)
+           << low + kBucketBits - 1 << std::right << std::setw(14)
+           << numerators << std::setw(14) << denominators << '\n';
+  }
+  output << "  Widest operand: " << widest << " of 127 bits\n";
+  output.flags(flags);
+  return output;
+}
+
+}  // namespace satisfactory
@@ -0,0 +1,119 @@
+#ifndef STATS_HPP_
+#define STATS_HPP_
+
+#include "allocation.hpp"
+#include "rational.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+
+namespace satisfactory {
+
+// The time spent in a phase of work, and the allocations made during it.
+struct PhaseStats {
+  std::chrono::steady_clock::duration time{};
+  AllocationCounts allocations;
+};
+
+// Prints a phase as a single line of a table, without a trailing newline.
+std::ostream& operator<<(std::ostream& output, const PhaseStats& phase);
+
+// Measurements of a single solve, for working out where the time goes and how
+// close the exact arithmetic is to overflowing.
+struct SolveStats {
+  using Clock = std::chrono::steady_clock;
+
+  // Each phase of the solve. The phases from resources to extract_solution
+  // are summed over the blocks of the problem, and pivot_loop and bit_widths
+  // also over the workers of a branch-and-bound search. bit_widths is the time
+  // taken to fill in the histograms below, which scan the whole tableau after
+  // each pivot, and is left out of pivot_loop. print is measured by the
+  // caller, as it is not part of the solve itself.
+  PhaseStats decompose, resources, interior_point, build_tableau, pivot_loop,
+      bit_widths, extract_solution, get_rates, print;
+  // The number of independent blocks that the problem was split into, and how
+  // many of those were solved as generalized networks.
+  int blocks = 0, network_blocks = 0;
+  // Whether the solution was served from the solution cache, in which case only
+  // get_rates and print are measured.
+  bool cached = false;
+
+  // Pivots performed by the simplex algorithm, and how many of those were
+  // degenerate (that is, they did not improve the objective).
+  std::int64_t pivots = 0, degenerate_pivots = 0;
+
+  // The dimensions of the tableau and its number of non-zero entries, both
+  // initially and once optimal. With several blocks, these are the sums over
+  // the tableau of each block.
+  int rows = 0, columns = 0;
+  std::int64_t initial_nonzeros = 0, final_nonzeros = 0;
+
+  // With column generation, the number of times that the inactive recipes were
+  // priced out and the number of recipes in the final tableau.
+  int pricing_rounds = 0, active_recipes = 0;
+
+  // The number of blocks solved by the interior-point method, and the total
+  // number of its iterations.
+  int interior_point_blocks = 0, interior_point_iterations = 0;
+
+  // The number of blocks solved directly from the warm start basis, without a
+  // tableau, and the number of primes that their systems were solved modulo.
+  int basis_blocks = 0, primes = 0;
+
+  // With a granularity, the number of branch-and-bound nodes whose tableau was
+  // solved.
+  std::int64_t nodes = 0;
+
+  // numerator_bits[b] is the number of non-zero tableau entries whose
+  // numerator has a magnitude of b bits, summed over the initial tableau and
+  // the tableau after each pivot. Likewise for denominator_bits. Entries which
+  // approach 127 bits are close to overflowing an int128.
+  std::array<std::int64_t, 129> numerator_bits = {}, denominator_bits = {};
+
+  // Adds the non-zero values to the bit width histograms and returns how many
+  // there were.
+  std::int64_t CountBitWidths(std::span<const Rational> values);
+
+  // Adds the measurements of another solve, such as that of another block.
+  SolveStats& operator+=(const SolveStats& other);
+};
+
+std::ostream& operator<<(std::ostream& output, const SolveStats& stats);
+
+// Adds the time and allocations between its construction and destruction to
+// a phase, unless the phase is null. The time added to excluded in between,
+// such as by a phase nested within this one, is left out.
+class PhaseScope {
+ public:
+  explicit PhaseScope(PhaseStats* phase,
+                      const PhaseStats* excluded = nullptr) noexcept
+      : phase_(phase),
+        allocations_(phase ? &phase->allocations : nullptr),
+        excluded_(phase ? excluded : nullptr),
+        excluded_start_(excluded_ ? excluded_->time
+                                  : SolveStats::Clock::duration()),
+        start_(phase ? SolveStats::Clock::now()
+                     : SolveStats::Clock::time_point()) {}
+  ~PhaseScope() {
+    if (!phase_) return;
+    phase_->time += SolveStats::Clock::now() - start_;
+    if (excluded_) phase_->time -= excluded_->time - excluded_start_;
+  }
+
+  PhaseScope(const PhaseScope&) = delete;
+  PhaseScope& operator=(const PhaseScope&) = delete;
+
+ private:
+  PhaseStats* phase_;
+  AllocationScope allocations_;
+  const PhaseStats* excluded_;
+  SolveStats::Clock::duration excluded_start_;
+  SolveStats::Clock::time_point start_;
+};
+
+}  // namespace satisfactory
+
+#endif  // STATS_HPP_
@@ -0,0 +1,714 @@
+// A differential stress test for the solver. Problems are generated at random
+// and each solution is checked against an independent reference:
+//
+//   * Every solution must be feasible and its cost must match its uses, as
+//     computed directly from the recipes, and its certificate must prove it
+//     optimal.
+//   * For small problems, the cost must match the optimum found by enumerating
+//     every vertex of the feasible region. Problems with limits may have no
+//     feasible region, in which case the solver must not find a solution.
+//   * Reordering the recipes, warm starting from a different basis, solving
+//     by column generation or by the interior-point method must not change the
+//     optimal cost, and allocating the tableaus from a pool must not change
+//     the solution. Nor must a solution cache, even for repeated demands.
+//   * Minimizing the machines after the cost must keep the optimal cost, and
+//     for small problems give the fewest machines of any cheapest vertex.
+//   * For small problems, moving a demand or the cost of a recipe to the end
+//     of its range from the sensitivity analysis must change the cost as the
+//     analysis predicts.
+//   * For small problems, the cheapest solution in whole multiples of a
+//     granularity must be feasible, and must not depend on the number of
+//     threads which search for it.
+//   * Solving asynchronously must report a rising lower bound on the cost, and
+//     cancelling the solve or letting its deadline pass must stop it.
+//   * Sweeping a demand must give the optimal cost at each breakpoint, and the
+//     interpolated solution between breakpoints must be feasible and optimal.
+//   * Parsing into FlatRecipes, as is done at compile time, must give the same
+//     recipes, and the built-in base game database must match building.txt.
+//   * The server must answer requests which cannot be solved with an error.
+//
+// Usage: stress_test [--iterations=<n>] [--seed=<n>]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "base_game.hpp"
+#include "basis.hpp"
+#include "cache.hpp"
+#include "certificate.hpp"
+#include "generator.hpp"
+#include "module.hpp"
+#include "parser.hpp"
+#include "server.hpp"
+#include "solver.hpp"
+#include "table.hpp"
+#include "task.hpp"
+
+namespace satisfactory {
+namespace {
+
+// Problems with more candidate vertices than this are not brute forced.
+constexpr std::int64_t kMaxVertices = 1000;
+
+struct Failure {
+  const GeneratorOptions& options;
+  const std::string& source;
+};
+
+[[noreturn]] void Fail(const Failure& failure, std::string_view message) {
+  std::cerr << "FAILED (seed " << failure.options.seed << "): " << message
+            << "\n\n"
+            << failure.source;
+  std::exit(1);
+}
+
+// The constraints of the primal problem, Ax >= b, with one row per resource
+// and one column per recipe, followed by a row for each limit. Rates are per
+// second.
+struct Constraints {
+  std::vector<std::vector<Rational>> a;
+  std::vector<Rational> b;
+};
+
+Constraints GetConstraints(const Input& input,
+                           std::span<const Demand> demands) {
+  const std::vector<std::string_view> resources = Resources(input, demands);
+  const auto row = [&](std::string_view name) {
+    return std::ranges::lower_bound(resources, name) - resources.begin();
+  };
+  const int n = resources.size();
+  const int r = input.recipes.size();
+  Constraints constraints{.a = std::vector(n, std::vector<Rational>(r)),
+                          .b = std::vector<Rational>(n)};
+  for (int i = 0; i < r; i++) {
+    const Recipe& recipe = input.recipes[i];
+    for (const auto& [resource, quantity] : recipe.inputs) {
+      constraints.a[row(resource)][i] -= quantity / recipe.duration;
+    }
+    for (const auto& [resource, quantity] : recipe.outputs) {
+      constraints.a[row(resource)][i] += quantity / recipe.duration;
+    }
+  }
+  for (const Demand& demand : demands) {
+    constraints.b[row(demand.name)] += demand.units_per_minute / 60;
+  }
+  // Limits are upper bounds, which are negated to fit the form Ax >= b.
+  for (int i = 0; i < r; i++) {
+    if (!input.recipes[i].limit) continue;
+    constraints.a.push_back(std::vector<Rational>(r));
+    constraints.a.back()[i] = -1;
+    constraints.b.push_back(-*input.recipes[i].limit);
+  }
+  for (const Demand& limit : input.limits) {
+    const int j = row(limit.name);
+    constraints.a.push_back(std::vector<Rational>(r));
+    for (int i = 0; i < r; i++) {
+      constraints.a.back()[i] = -std::max(constraints.a[j][i], Rational(0));
+    }
+    constraints.b.push_back(-limit.units_per_minute / 60);
+  }
+  return constraints;
+}
+
+Rational Cost(const Input& input, std::span<const Rational> uses) {
+  Rational cost = 0;
+  for (std::size_t i = 0; i < uses.size(); i++) {
+    cost += input.recipes[i].cost * uses[i];
+  }
+  return cost;
+}
+
+void CheckFeasible(const Failure& failure, const Input& input,
+                   std::span<const Demand> demands, const Solution& solution) {
+  const Constraints constraints = GetConstraints(input, demands);
+  for (const Rational& x : solution.uses) {
+    if (x < 0) Fail(failure, "negative recipe use");
+  }
+  for (std::size_t j = 0; j < constraints.b.size(); j++) {
+    Rational total = 0;
+    for (std::size_t i = 0; i < solution.uses.size(); i++) {
+      total += constraints.a[j][i] * solution.uses[i];
+    }
+    if (total < constraints.b[j]) Fail(failure, "demand is not met");
+  }
+  if (Cost(input, solution.uses) != solution.cost) {
+    Fail(failure, "cost does not match the recipe uses");
+  }
+}
+
+// Solves the square system ax = b, returning std::nullopt if it is singular.
+std::optional<std::vector<Rational>> SolveSystem(
+    std::vector<std::vector<Rational>> a, std::vector<Rational> b) {
+  const int n = b.size();
+  for (int c = 0; c < n; c++) {
+    int pivot = c;
+    while (pivot < n && a[pivot][c] == 0) pivot++;
+    if (pivot == n) return std::nullopt;
+    std::swap(a[c], a[pivot]);
+    std::swap(b[c], b[pivot]);
+    for (int y = 0; y < n; y++) {
+      if (y == c || a[y][c] == 0) continue;
+      const Rational f = a[y][c] / a[c][c];
+      for (int x = c; x < n; x++) a[y][x] -= f * a[c][x];
+      b[y] -= f * b[c];
+    }
+  }
+  for (int y = 0; y < n; y++) b[y] /= a[y][y];
+  return b;
+}
+
+std::int64_t Binomial(int n, int k) {
+  std::int64_t result = 1;
+  for (int i = 1; i <= k; i++) {
+    result = result * (n - k + i) / i;
+    if (result > kMaxVertices) return result;
+  }
+  return result;
+}
+
+bool HasLimits(const Input& input) {
+  return !input.limits.empty() ||
+         std::ranges::any_of(input.recipes, [](const Recipe& recipe) {
+           return recipe.limit.has_value();
+         });
+}
+
+// The result of a brute force search: the optimal cost, or std::nullopt if
+// there is no feasible solution.
+struct Optimum {
+  std::optional<Rational> cost;
+  // The fewest machines of the solutions with the optimal cost.
+  std::optional<Rational> machines;
+};
+
+Rational Machines(std::span<const Rational> uses) {
+  Rational machines = 0;
+  for (const Rational& x : uses) machines += x;
+  return machines;
+}
+
+// Finds the optimal cost by trying every choice of r tight constraints among
+// the resource constraints and the non-negativity constraints. Since the costs
+// are non-negative and x >= 0, the optimum is attained at one of these
+// vertices, and so are the fewest machines among the optimal solutions.
+// Returns std::nullopt if there are too many vertices to try.
+std::optional<Optimum> BruteForce(const Input& input,
+                                  std::span<const Demand> demands) {
+  Constraints constraints = GetConstraints(input, demands);
+  // Constraints on resources such as (Node), which no recipe consumes or
+  // produces any of, are trivially satisfied and only slow down the search.
+  const auto is_zero = [](const Rational& x) { return x == 0; };
+  for (int j = constraints.b.size() - 1; j >= 0; j--) {
+    if (constraints.b[j] == 0 &&
+        std::ranges::all_of(constraints.a[j], is_zero)) {
+      constraints.a.erase(constraints.a.begin() + j);
+      constraints.b.erase(constraints.b.begin() + j);
+    }
+  }
+  const int r = input.recipes.size();
+  for (int i = 0; i < r; i++) {
+    constraints.a.push_back(std::vector<Rational>(r));
+    constraints.a.back()[i] = 1;
+    constraints.b.push_back(0);
+  }
+  const int m = constraints.b.size();
+  if (Binomial(m, r) > kMaxVertices) return std::nullopt;
+  Optimum best;
+  std::vector<bool> chosen(m, false);
+  std::fill(chosen.end() - r, chosen.end(), true);
+  do {
+    std::vector<std::vector<Rational>> a;
+    std::vector<Rational> b;
+    for (int j = 0; j < m; j++) {
+      if (!chosen[j]) continue;
+      a.push_back(constraints.a[j]);
+      b.push_back(constraints.b[j]);
+    }
+    const std::optional<std::vector<Rational>> x = SolveSystem(a, b);
+    if (!x) continue;
+    const bool feasible = std::ranges::all_of(
+        std::views::iota(0, m), [&](int j) {
+          Rational total = 0;
+          for (int i = 0; i < r; i++) total += constraints.a[j][i] * (*x)[i];
+          return total >= constraints.b[j];
+        });
+    if (!feasible) continue;
+    const Rational cost = Cost(input, *x);
+    const Rational machines = Machines(*x);
+    if (!best.cost || cost < *best.cost ||
+        (cost == *best.cost && machines < *best.machines)) {
+      best = {.cost = cost, .machines = machines};
+    }
+  } while (std::next_permutation(chosen.begin(), chosen.end()));
+  return best;
+}
+
+// Solves a problem and checks its certificate, which must prove it optimal.
+std::optional<Solution> SolveCertified(const Failure& failure,
+                                       const Input& input,
+                                       std::span<const Demand> demands,
+                                       SolveOptions options) {
+  std::optional<Certificate> certificate;
+  options.certificate = &certificate;
+  std::optional<Solution> solution = Solve(input, demands, options);
+  if (!solution) return std::nullopt;
+  if (!certificate) Fail(failure, "the solution has no certificate");
+  if (const std::optional<std::string> error =
+          CheckCertificate(input, demands, *solution, *certificate)) {
+    Fail(failure, "the certificate is wrong: " + *error);
+  }
+  // A more expensive solution is not optimal.
+  Solution worse = *solution;
+  for (Rational& use : worse.uses) use *= 2;
+  worse.cost *= 2;
+  if (worse.cost != solution->cost &&
+      !CheckCertificate(input, demands, worse, *certificate)) {
+    Fail(failure, "the certificate proves a worse solution optimal");
+  }
+  return solution;
+}
+
+// Solves one generated problem in several ways and checks that they agree.
+bool SameRecipe(const Recipe& a, const FlatRecipe& b) {
+  const std::map<std::string_view, Rational> inputs(b.inputs.begin(),
+                                                    b.inputs.end());
+  const std::map<std::string_view, Rational> outputs(b.outputs.begin(),
+                                                     b.outputs.end());
+  return a.inputs == inputs && a.outputs == outputs &&
+         a.duration == b.duration && a.cost == b.cost && a.limit == b.limit;
+}
+
+bool SameDemands(std::span<const Demand> a, std::span<const Demand> b) {
+  return std::ranges::equal(a, b, [](const Demand& x, const Demand& y) {
+    return x.name == y.name && x.units_per_minute == y.units_per_minute;
+  });
+}
+
+void Check(const GeneratorOptions& options) {
+  const std::string source = GenerateInput(options);
+  const Failure failure{.options = options, .source = source};
+  const Input input = *ParseInput(source, "generated");
+  const FlatInput flat = Parser(source, "generated").ParseInput<FlatInput>();
+  if (!std::ranges::equal(input.recipes, flat.recipes, SameRecipe) ||
+      !SameDemands(input.demands, flat.demands) ||
+      !SameDemands(input.limits, flat.limits)) {
+    Fail(failure, "parsing into FlatRecipes changed the input");
+  }
+  const bool limited = HasLimits(input);
+  const std::optional<Optimum> optimum = BruteForce(input, input.demands);
+  Basis basis;
+  const std::optional<Solution> solution =
+      SolveCertified(failure, input, input.demands, {.final_basis = &basis});
+  if (!solution) {
+    // Only limits can make a generated problem infeasible.
+    if (!limited || (optimum && optimum->cost)) {
+      Fail(failure, "no solution was found");
+    }
+    return;
+  }
+  CheckFeasible(failure, input, input.demands, *solution);
+
+  // Decomposing the problem must give an equally optimal solution to solving
+  // it on one tableau, and exactly the same solution when each block is
+  // solved on a tableau too, rather than some of them as networks.
+  const std::optional<Solution> monolithic =
+      SolveCertified(failure, input, input.demands, {.decompose = false});
+  if (!monolithic || monolithic->cost != solution->cost) {
+    Fail(failure, "decomposing the problem changed the cost");
+  }
+  CheckFeasible(failure, input, input.demands, *monolithic);
+  const std::optional<Solution> one_tableau = SolveCertified(
+      failure, input, input.demands, {.decompose = false, .network = false});
+  const std::optional<Solution> block_tableaus =
+      SolveCertified(failure, input, input.demands, {.network = false});
+  if (!one_tableau || !block_tableaus ||
+      one_tableau->uses != block_tableaus->uses) {
+    Fail(failure, "decomposing the problem changed the solution");
+  }
+
+  // Allocating the tableaus from a pool must not change the solution, and
+  // solving again must reuse every buffer of the first solve.
+  TablePool pool;
+  for (int k = 0; k < 2; k++) {
+    const std::optional<Solution> pooled = SolveCertified(
+        failure, input, input.demands, {.pool = &pool, .decompose = false});
+    if (!pooled || pooled->uses != monolithic->uses) {
+      Fail(failure, "allocating tableaus from a pool changed the solution");
+    }
+  }
+  if (pool.reuses() * 2 != pool.allocations()) {
+    Fail(failure, "the tableaus of the second solve were not reused");
+  }
+
+  // A solution cache must tell apart demands which are repeated, since they
+  // add up, from a single demand.
+  if (!input.demands.empty()) {
+    SolutionCache cache(16);
+    std::vector<Demand> repeated = input.demands;
+    repeated.push_back(input.demands.front());
+    const std::optional<Solution> single =
+        Solve(input, input.demands, {.cache = &cache});
+    const std::optional<Solution> cached =
+        Solve(input, repeated, {.cache = &cache});
+    const std::optional<Solution> uncached = Solve(input, repeated);
+    if (!single || single->cost != solution->cost ||
+        cached.has_value() != uncached.has_value() ||
+        (cached && cached->cost != uncached->cost)) {
+      Fail(failure, "the solution cache mistook a repeated demand");
+    }
+  }
+
+  // Minimizing the machines among the cheapest solutions must not change the
+  // cost, nor use more machines than another cheapest solution, whether or not
+  // the problem is decomposed.
+  const std::vector<Objective> objectives = {
+      {.kind = Objective::Kind::kCost}, {.kind = Objective::Kind::kMachines}};
+  for (const bool decompose : {true, false}) {
+    const std::optional<Solution> fewest = Solve(
+        input, input.demands,
+        {.decompose = decompose, .objectives = objectives});
+    if (!fewest || fewest->cost != solution->cost) {
+      Fail(failure, "minimizing the machines changed the cost");
+    }
+    CheckFeasible(failure, input, input.demands, *fewest);
+    const Rational machines = Machines(fewest->uses);
+    if (machines > Machines(solution->uses) ||
+        machines > Machines(monolithic->uses) ||
+        (optimum && machines != optimum->machines)) {
+      Fail(failure, "the machines were not minimized");
+    }
+  }
+
+  // So must solving the blocks which are generalized networks without a
+  // tableau.
+  const std::optional<Solution> tableau =
+      SolveCertified(failure, input, input.demands, {.network = false});
+  if (!tableau || tableau->cost != solution->cost) {
+    Fail(failure, "solving networks without a tableau changed the cost");
+  }
+
+  // Column generation must find an equally optimal solution, though not
+  // necessarily the same one.
+  const std::optional<Solution> lazy = SolveCertified(
+      failure, input, input.demands, {.column_generation = true});
+  if (!lazy || lazy->cost != solution->cost) {
+    Fail(failure, "column generation changed the cost");
+  }
+  CheckFeasible(failure, input, input.demands, *lazy);
+
+  // So must the interior-point method, once crossover has confirmed its basis
+  // in exact arithmetic.
+  const std::optional<Solution> interior =
+      SolveCertified(failure, input, input.demands,
+                     {.engine = Engine::kInteriorPoint});
+  if (!interior || interior->cost != solution->cost) {
+    Fail(failure, "the interior-point method changed the cost");
+  }
+  CheckFeasible(failure, input, input.demands, *interior);
+
+  if (optimum && optimum->cost != solution->cost) {
+    Fail(failure, "the cost is not optimal");
+  }
+
+  // Within the ranges of the sensitivity analysis, changing a demand changes
+  // the cost at the marginal cost of the resource, and changing the cost of a
+  // recipe changes the total cost in proportion to its use in the analyzed
+  // solution, which may differ from the others if there are ties.
+  if (optimum) {
+    const std::optional<Solution> analyzed =
+        Solve(input, input.demands, {.sensitivity = true});
+    if (!analyzed || !analyzed->sensitivity ||
+        analyzed->cost != solution->cost) {
+      Fail(failure, "sensitivity analysis changed the cost");
+    }
+    const Sensitivity& sensitivity = *analyzed->sensitivity;
+    // A point at the end of a range, or just past a finite value if the range
+    // is unbounded.
+    const auto ends = [](const Range& range, const Rational& value) {
+      return std::vector{range.lower.value_or(value - 1),
+                         range.upper.value_or(value + 1)};
+    };
+    for (const auto& [resource, range] : sensitivity.demand_ranges) {
+      Rational total = 0;
+      for (const Demand& demand : input.demands) {
+        if (demand.name == resource) total += demand.units_per_minute;
+      }
+      for (const Rational& end : ends(range, total)) {
+        std::vector<Demand> changed = input.demands;
+        changed.push_back({.name = resource, .units_per_minute = end - total});
+        const std::optional<Solution> moved = Solve(input, changed);
+        if (!moved || moved->cost != solution->cost +
+                                          sensitivity.prices.at(resource) *
+                                              (end - total)) {
+          Fail(failure, "a demand range or marginal cost is wrong");
+        }
+      }
+    }
+    for (std::size_t i = 0; i < input.recipes.size(); i++) {
+      const Rational& cost = input.recipes[i].cost;
+      for (const Rational& end : ends(sensitivity.cost_ranges[i], cost)) {
+        Input changed = input;
+        changed.recipes[i].cost = end;
+        const std::optional<Solution> moved = Solve(changed);
+        if (!moved || moved->cost != solution->cost +
+                                          (end - cost) * analyzed->uses[i]) {
+          Fail(failure, "a cost range is wrong");
+        }
+      }
+      if (analyzed->uses[i] != 0 && sensitivity.reduced_costs[i] != 0) {
+        Fail(failure, "a recipe in use has a reduced cost");
+      }
+    }
+  }
+
+  // Whole multiples of a granularity can only cost more, and exploring the
+  // branch-and-bound tree on several threads must not change the cost. Only
+  // problems small enough to brute force are searched, as others can take too
+  // long.
+  if (optimum) {
+    const Rational granularity = options.seed % 2 == 0 ? 1 : Rational(1, 4);
+    const std::optional<Solution> whole =
+        Solve(input, input.demands, {.granularity = granularity});
+    const std::optional<Solution> parallel = Solve(
+        input, input.demands, {.granularity = granularity, .threads = 3});
+    if (whole.has_value() != parallel.has_value() ||
+        (whole && whole->cost != parallel->cost)) {
+      Fail(failure, "branching on several threads changed the cost");
+    }
+    // Only limits can rule out whole multiples.
+    if (!whole && !limited) Fail(failure, "no whole solution was found");
+    if (whole) {
+      CheckFeasible(failure, input, input.demands, *whole);
+      if (whole->cost < solution->cost) {
+        Fail(failure, "whole multiples are cheaper than the optimum");
+      }
+      for (const Rational& x : whole->uses) {
+        if ((x / granularity).denominator() != 1) {
+          Fail(failure, "a recipe use is not a whole multiple");
+        }
+      }
+    }
+  }
+
+  // Solving on another thread, which reports a lower bound on the cost as it
+  // progresses, and pivots more often without solving networks. A deadline
+  // which has already passed stops the solve before it starts, while a
+  // cancellation races with it.
+  {
+    std::vector<Progress> progress;
+    SolveTask task(
+        input, input.demands,
+        {.network = false,
+         .progress = [&](const Progress& p) { progress.push_back(p); }});
+    const std::optional<Solution> solved = task.Get();
+    if (!solved || solved->cost != solution->cost || task.stopped()) {
+      Fail(failure, "solving asynchronously changed the cost");
+    }
+    for (std::size_t k = 0; k < progress.size(); k++) {
+      if (progress[k].bound > solution->cost ||
+          (k > 0 && (progress[k].pivots <= progress[k - 1].pivots ||
+                     progress[k].bound < progress[k - 1].bound))) {
+        Fail(failure, "the progress of a solve is wrong");
+      }
+    }
+    SolveTask late(input, input.demands,
+                   {.deadline = std::chrono::steady_clock::now()});
+    if (late.Get() || !late.stopped()) {
+      Fail(failure, "a solve continued past its deadline");
+    }
+    SolveTask cancelled(input, input.demands);
+    cancelled.Cancel();
+    const std::optional<Solution> raced = cancelled.Get();
+    if (cancelled.stopped() ? raced.has_value()
+                            : !raced || raced->cost != solution->cost) {
+      Fail(failure, "cancelling a solve gave a wrong solution");
+    }
+  }
+
+  // Sweeping the first demand from its rate to four times its rate. Between
+  // breakpoints, the cost is linear and the interpolated uses meet the
+  // demands, and past the last breakpoint, the demands cannot be met.
+  const Demand direction = input.demands.front();
+  const auto at = [&](const Rational& t) {
+    std::vector<Demand> demands = input.demands;
+    demands.push_back({.name = direction.name,
+                       .units_per_minute = t * direction.units_per_minute});
+    return demands;
+  };
+  const std::vector<Breakpoint> breakpoints =
+      Sweep(input, input.demands, {&direction, 1}, 0, 3);
+  if (breakpoints.empty() || breakpoints.front().t != 0 ||
+      breakpoints.front().solution.cost != solution->cost) {
+    Fail(failure, "the sweep does not start at the optimum");
+  }
+  for (std::size_t k = 0; k < breakpoints.size(); k++) {
+    const auto& [t, swept] = breakpoints[k];
+    const std::optional<Solution> solved = Solve(input, at(t));
+    if (!solved || solved->cost != swept.cost) {
+      Fail(failure, "a breakpoint of the sweep is not optimal");
+    }
+    CheckFeasible(failure, input, at(t), swept);
+    if (k == 0) continue;
+    const Breakpoint& previous = breakpoints[k - 1];
+    std::vector<Rational> uses(swept.uses.size());
+    for (std::size_t i = 0; i < uses.size(); i++) {
+      uses[i] = (previous.solution.uses[i] + swept.uses[i]) / 2;
+    }
+    const Rational middle = (previous.t + t) / 2;
+    const std::optional<Solution> between = Solve(input, at(middle));
+    if (!between || between->cost != Cost(input, uses)) {
+      Fail(failure, "the sweep is not linear between breakpoints");
+    }
+    CheckFeasible(failure, input, at(middle),
+                  {.input = &input,
+                   .uses = uses,
+                   .total = {},
+                   .net = {},
+                   .cost = between->cost,
+                   .sensitivity = std::nullopt});
+  }
+  if (const Rational& last = breakpoints.back().t; last < 3) {
+    if (Solve(input, at((last + 3) / 2))) {
+      Fail(failure, "the sweep stopped while the demands could be met");
+    }
+  }
+
+  // The same recipes in a different order.
+  Input shuffled = input;
+  std::mt19937_64 random(options.seed);
+  std::ranges::shuffle(shuffled.recipes, random);
+  const std::optional<Solution> reordered = Solve(shuffled);
+  if (!reordered || reordered->cost != solution->cost) {
+    Fail(failure, "reordering the recipes changed the cost");
+  }
+
+  // Warm starting from the optimal basis for different demands. Without
+  // limits, doubling the demands doubles the cost, while with limits, it may
+  // not even be possible.
+  std::vector<Demand> doubled = input.demands;
+  for (Demand& demand : doubled) demand.units_per_minute *= 2;
+  const std::optional<Solution> warm =
+      SolveCertified(failure, input, doubled, {.warm_start = &basis});
+  const std::optional<Solution> cold = Solve(input, doubled);
+  if (limited && !warm && !cold) return;
+  if (!warm || !cold || warm->cost != cold->cost ||
+      (!limited && cold->cost != 2 * solution->cost)) {
+    Fail(failure, "warm starting changed the cost");
+  }
+  CheckFeasible(failure, input, doubled, *warm);
+}
+
+// The base game database, which is parsed at compile time, must match
+// building.txt as loaded at run time.
+void CheckBaseGame() {
+  const auto fail = [](std::string_view message) {
+    std::cerr << "FAILED: " << message << '\n';
+    std::exit(1);
+  };
+  ModuleCache modules;
+  const Input& expected =
+      *modules.Load(std::filesystem::path(SOURCE_DIR) / "building.txt");
+  const Input& actual = BaseGame();
+  const auto same_recipe = [](const Recipe& a, const Recipe& b) {
+    return a.inputs == b.inputs && a.outputs == b.outputs &&
+           a.duration == b.duration && a.cost == b.cost && a.limit == b.limit;
+  };
+  if (actual.imports != expected.imports ||
+      !std::ranges::equal(actual.recipes, expected.recipes, same_recipe) ||
+      !SameDemands(actual.demands, expected.demands) ||
+      !SameDemands(actual.limits, expected.limits) ||
+      !actual.scenarios.empty()) {
+    fail("the base game database does not match building.txt");
+  }
+}
+
+// A server must answer requests for malformed databases and for resources
+// without recipes with an error, rather than exiting.
+void CheckServerErrors() {
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path();
+  const std::filesystem::path malformed = directory / "stress_malformed.txt";
+  const std::filesystem::path zero = directory / "stress_zero.txt";
+  const std::filesystem::path valid = directory / "stress_valid.txt";
+  std::ofstream(malformed) << "(Free) -> 1 X (1 s/run, cost 1/0)\n";
+  std::ofstream(zero) << "(Free) -> 1 X (0 s/run, cost 1)\n";
+  std::ofstream(valid) << "(Free) -> 1 X (1 s/run, cost 1)\n";
+  ModuleCache modules;
+  Server server(modules, {}, Numbers::kExact, 1);
+  // A zero duration would divide by zero when solving, so it must be rejected
+  // before it reaches the solver, and the server must keep answering after it.
+  const std::tuple<std::string, std::string_view, std::string_view> cases[] = {
+      {"1 " + malformed.string() + " X 1", "error",
+       ":1:33: error: expected a non-zero denominator"},
+      {"2 " + valid.string() + " Y 1", "error", "no recipe for Y"},
+      {"3 " + zero.string() + " X 1", "error",
+       ":1:17: error: expected a non-zero duration"},
+      {"4 " + valid.string() + " X 1", "ok", "\"id\":\"4\""},
+  };
+  for (const auto& [request, status, message] : cases) {
+    const std::string response = server.Handle(request);
+    if (response.find("\"status\":\"" + std::string(status) + "\"") ==
+            response.npos ||
+        response.find(message) == response.npos) {
+      std::cerr << "FAILED: the server responded to " << request << " with "
+                << response;
+      std::exit(1);
+    }
+  }
+  std::filesystem::remove(malformed);
+  std::filesystem::remove(zero);
+  std::filesystem::remove(valid);
+}
+
+}  // namespace
+}  // namespace satisfactory
+
+int main(int argc, char* argv[]) {
+  using namespace satisfactory;
+  int iterations = 200;
+  std::uint64_t seed = 1;
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg = argv[i];
+    const std::string value(arg.substr(arg.find('=') + 1));
+    if (arg.starts_with("--iterations=")) {
+      iterations = std::atoi(value.c_str());
+    } else if (arg.starts_with("--seed=")) {
+      seed = std::strtoull(value.c_str(), nullptr, 10);
+    } else {
+      std::cerr << "Usage: stress_test [--iterations=<n>] [--seed=<n>]\n";
+      return 1;
+    }
+  }
+  CheckBaseGame();
+  CheckServerErrors();
+  for (int i = 0; i < iterations; i++) {
+    // Mostly small problems which can be brute forced, with the occasional
+    // larger one.
+    const bool large = i % 20 == 19;
+    Check({.seed = seed + i,
+           .resources = large ? 25 : 4 + i % 3,
+           .depth = large ? 4 : 1 + i % 2,
+           // Single inputs give sparse graphs, which decompose into blocks.
+           .max_inputs = i % 7 < 3 ? 1 : large ? 3 : 2,
+           .alternates = large ? 1.5 : 0.5,
+           .byproducts = 0.3,
+           .degeneracy = i % 3 == 0 ? 0.5 : 0,
+           .demands = large ? 4 : 2,
+           .scenarios = 0,
+           .limits = i % 4 == 1 ? 0.3 : 0});
+  }
+  std::cout << "PASSED " << iterations << " problems\n";
+}
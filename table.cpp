@@ -1 +1,76 @@
 #include "table.hpp"
+
+namespace satisfactory {
+namespace {
+
+// The pool keeps at most this many bytes of buffers which are not in use.
+constexpr std::size_t kMaxFreeBytes = std::size_t(1) << 28;
+
+}  // namespace
+
+TablePool::~TablePool() {
+  for (const auto& [bytes, buffer] : free_) {
+    ::operator delete(buffer, bytes, std::align_val_t(kCacheLine));
+  }
+}
+
+void* TablePool::Allocate(std::size_t bytes) {
+  {
+    std::unique_lock lock(mutex_);
+    allocations_++;
+    // Only buffers of exactly the right size are reused, which is usual for
+    // the tableaus of similar problems.
+    if (auto i = free_.find(bytes); i != free_.end()) {
+      void* const buffer = i->second;
+      free_.erase(i);
+      free_bytes_ -= bytes;
+      reuses_++;
+      return buffer;
+    }
+  }
+  return ::operator new(bytes, std::align_val_t(kCacheLine));
+}
+
+void TablePool::Release(void* buffer, std::size_t bytes) noexcept {
+  std::unique_lock lock(mutex_);
+  // The smallest buffers are evicted to make room, as larger ones are more
+  // costly to allocate.
+  while (!free_.empty() && free_bytes_ + bytes > kMaxFreeBytes &&
+         free_.begin()->first < bytes) {
+    const auto [size, evicted] = *free_.begin();
+    ::operator delete(evicted, size, std::align_val_t(kCacheLine));
+    free_bytes_ -= size;
+    free_.erase(free_.begin());
+  }
+  if (free_bytes_ + bytes > kMaxFreeBytes) {
+    ::operator delete(buffer, bytes, std::align_val_t(kCacheLine));
+    return;
+  }
+  free_.emplace(bytes, buffer);
+  free_bytes_ += bytes;
+}
+
+std::int64_t TablePool::allocations() const {
+  std::unique_lock lock(mutex_);
+  return allocations_;
+}
+
+std::int64_t TablePool::reuses() const {
+  std::unique_lock lock(mutex_);
+  return reuses_;
+}
+
+void* AllocateTable(TablePool* pool, std::size_t bytes) {
+  if (pool) return pool->Allocate(bytes);
+  return ::operator new(bytes, std::align_val_t(kCacheLine));
+}
+
+void ReleaseTable(TablePool* pool, void* buffer, std::size_t bytes) noexcept {
+  if (pool) {
+    pool->Release(buffer, bytes);
+  } else {
+    ::operator delete(buffer, bytes, std::align_val_t(kCacheLine));
+  }
+}
+
+}  // namespace satisfactory
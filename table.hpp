@@ -1,62 +1,135 @@
 #ifndef TABLE_HPP_
 #define TABLE_HPP_
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <numeric>
 #include <span>
+#include <type_traits>
 #include <utility>
 
 namespace satisfactory {
 
+// Each row of a table starts on a cache line, so that a row spans no more lines
+// than its values need and passes over a row start at a line boundary.
+inline constexpr std::size_t kCacheLine = 64;
+
+// A pool of buffers which tables can be allocated from. A table returns its
+// buffer to the pool when it is destroyed, and a later table of a similar size
+// reuses it rather than allocating memory anew, as when solving many similar
+// problems in turn. The pool must outlive its tables. It is safe to share
+// between threads.
+class TablePool {
+ public:
+  TablePool() = default;
+  TablePool(const TablePool&) = delete;
+  TablePool& operator=(const TablePool&) = delete;
+  ~TablePool();
+
+  // Returns a buffer of the given size, which must be a multiple of
+  // kCacheLine, aligned to a cache line.
+  void* Allocate(std::size_t bytes);
+  // Returns a buffer given by Allocate to the pool.
+  void Release(void* buffer, std::size_t bytes) noexcept;
+
+  // The number of calls to Allocate, and how many of them reused a buffer.
+  std::int64_t allocations() const;
+  std::int64_t reuses() const;
+
+ private:
+  mutable std::mutex mutex_;
+  // The buffers which are not in use, by size.
+  std::multimap<std::size_t, void*> free_;
+  std::size_t free_bytes_ = 0;
+  std::int64_t allocations_ = 0, reuses_ = 0;
+};
+
+// Allocates a buffer aligned to a cache line from the pool, or from the heap if
+// the pool is null, and likewise releases it.
+void* AllocateTable(TablePool* pool, std::size_t bytes);
+void ReleaseTable(TablePool* pool, void* buffer, std::size_t bytes) noexcept;
+
+// A two-dimensional array of values, stored row by row. Rows are padded to
+// a whole number of cache lines. The storage is allocated uninitialized and
+// then filled, so the values must be trivially copyable and destructible.
 template <typename T>
 class Table {
+  static_assert(std::is_trivially_copyable_v<T> &&
+                std::is_trivially_destructible_v<T>);
+
  public:
   constexpr Table() noexcept = default;
-  Table(int width, int height) noexcept
-      : width_(width),
-        height_(height),
-        data_(std::make_unique<T[]>(width * height)) {}
-
-  Table(const Table& other) noexcept : Table(other.width_, other.height_) {
-    const int size = width_ * height_;
-    std::copy(other.data_.get(), other.data_.get() + size, data_.get());
+  // A table whose values are all T(), allocated from the pool if it is
+  // non-null.
+  Table(int width, int height, TablePool* pool = nullptr)
+      : width_(width), height_(height), stride_(Stride(width)), pool_(pool) {
+    Allocate();
+    std::uninitialized_fill_n(data_, stride_ * height_, T());
+  }
+
+  Table(const Table& other)
+      : width_(other.width_),
+        height_(other.height_),
+        stride_(other.stride_),
+        pool_(other.pool_) {
+    Allocate();
+    std::uninitialized_copy_n(other.data_, stride_ * height_, data_);
   }
 
-  Table& operator=(const Table& other) noexcept {
-    const int current_size = width_ * height_;
-    const int new_size = other.width_ * other.height_;
-    if (current_size != new_size) data_ = std::make_unique<T[]>(new_size);
+  Table& operator=(const Table& other) {
+    if (this == &other) return *this;
+    // The buffer is kept if it is the same size.
+    const bool reuse = Bytes() == other.Bytes() && pool_ == other.pool_;
+    if (!reuse) Release();
     width_ = other.width_;
     height_ = other.height_;
-    std::copy(other.data_.get(), other.data_.get() + new_size, data_.get());
+    stride_ = other.stride_;
+    pool_ = other.pool_;
+    if (!reuse) Allocate();
+    std::uninitialized_copy_n(other.data_, stride_ * height_, data_);
     return *this;
   }
 
   Table(Table&& other) noexcept
       : width_(std::exchange(other.width_, 0)),
         height_(std::exchange(other.height_, 0)),
-        data_(std::exchange(other.data_, nullptr)) {}
+        stride_(std::exchange(other.stride_, 0)),
+        data_(std::exchange(other.data_, nullptr)),
+        pool_(other.pool_) {}
 
   Table& operator=(Table&& other) noexcept {
-    data_ = std::exchange(other.data_, nullptr);
+    Release();
     width_ = std::exchange(other.width_, 0);
     height_ = std::exchange(other.height_, 0);
+    stride_ = std::exchange(other.stride_, 0);
+    data_ = std::exchange(other.data_, nullptr);
+    pool_ = other.pool_;
     return *this;
   }
 
+  ~Table() { Release(); }
+
   // Accessors
 
   constexpr int width() const noexcept { return width_; }
   constexpr int height() const noexcept { return height_; }
+  // The pool which the table was allocated from, if any.
+  constexpr TablePool* pool() const noexcept { return pool_; }
 
   constexpr std::span<T> Row(int y) noexcept {
     assert(0 <= y && y < height_);
-    return std::span(data_.get() + y * width_, width_);
+    return std::span(data_ + y * stride_, width_);
   }
 
   constexpr std::span<const T> Row(int y) const noexcept {
     assert(0 <= y && y < height_);
-    return std::span(data_.get() + y * width_, width_);
+    return std::span(data_ + y * stride_, width_);
   }
 
   constexpr std::span<T> operator[](int y) noexcept { return Row(y); }
@@ -65,8 +138,31 @@ class Table {
   }
 
  private:
-  int width_ = 0, height_ = 0;
-  std::unique_ptr<T[]> data_;
+  // The number of values from the start of one row to the next, which is the
+  // width rounded up to a whole number of cache lines.
+  static constexpr int Stride(int width) {
+    constexpr int kStep = kCacheLine / std::gcd(kCacheLine, sizeof(T));
+    return (width + kStep - 1) / kStep * kStep;
+  }
+
+  std::size_t Bytes() const noexcept {
+    return std::size_t(stride_) * height_ * sizeof(T);
+  }
+
+  void Allocate() {
+    data_ = Bytes() == 0
+                ? nullptr
+                : static_cast<T*>(AllocateTable(pool_, Bytes()));
+  }
+
+  void Release() noexcept {
+    if (data_) ReleaseTable(pool_, data_, Bytes());
+    data_ = nullptr;
+  }
+
+  int width_ = 0, height_ = 0, stride_ = 0;
+  T* data_ = nullptr;
+  TablePool* pool_ = nullptr;
 };
 
 }  // namespace satisfactory
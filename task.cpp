@@ -0,0 +1,31 @@
+#include "task.hpp"
+
+#include <chrono>
+#include <utility>
+
+namespace satisfactory {
+
+SolveTask::SolveTask(const Input& input, std::vector<Demand> demands,
+                     SolveOptions options) {
+  std::promise<std::optional<Solution>> promise;
+  result_ = promise.get_future();
+  options.stopped = &stopped_;
+  // The thread passes its stop token to the function, and setting the value of
+  // the promise makes stopped_ visible to the thread which gets the future.
+  thread_ = std::jthread([&input, demands = std::move(demands),
+                          options = std::move(options),
+                          promise = std::move(promise)](
+                             std::stop_token stop_token) mutable {
+    options.stop_token = std::move(stop_token);
+    promise.set_value(Solve(input, demands, options));
+  });
+}
+
+bool SolveTask::Ready() const {
+  return result_.wait_for(std::chrono::seconds(0)) ==
+         std::future_status::ready;
+}
+
+std::optional<Solution> SolveTask::Get() { return result_.get(); }
+
+}  // namespace satisfactory
@@ -0,0 +1,59 @@
+#ifndef TASK_HPP_
+#define TASK_HPP_
+
+#include "data.hpp"
+#include "solver.hpp"
+
+#include <future>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace satisfactory {
+
+// A solve running on a thread of its own, for interactive tools which must stay
+// responsive while it runs and may lose interest in it before it is done:
+//
+//   SolveTask task(input, demands, {.deadline = Clock::now() + 100ms});
+//   ...
+//   if (demands_changed) task.Cancel();
+//   if (task.Ready()) Show(task.Get());
+//
+// Progress is reported through the options, as for Solve. Destroying the task
+// cancels it and waits for its thread, which stops within a pivot.
+class SolveTask {
+ public:
+  // Starts solving for the demands. The input must outlive the task. The stop
+  // token of the options is replaced by that of the task, and the stopped
+  // output by its own.
+  SolveTask(const Input& input, std::vector<Demand> demands,
+            SolveOptions options = {});
+
+  SolveTask(const SolveTask&) = delete;
+  SolveTask& operator=(const SolveTask&) = delete;
+
+  // Asks the solve to stop as soon as possible. It then gives what Solve gives
+  // when stopped: std::nullopt, or with a granularity, the cheapest solution
+  // found so far.
+  void Cancel() { thread_.request_stop(); }
+
+  // Whether the result can be retrieved without waiting.
+  bool Ready() const;
+
+  // Waits for the result, which can only be retrieved once.
+  std::optional<Solution> Get();
+
+  // Whether the solve was stopped early, by Cancel or by its deadline. This is
+  // only known once the result is ready.
+  bool stopped() const { return stopped_; }
+
+ private:
+  bool stopped_ = false;
+  std::future<std::optional<Solution>> result_;
+  // Declared last so that it is joined before the other members are destroyed.
+  std::jthread thread_;
+};
+
+}  // namespace satisfactory
+
+#endif  // TASK_HPP_
@@ -0,0 +1,72 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace satisfactory {
+
+int NumThreads(int num_threads) {
+  if (num_threads > 0) return num_threads;
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+ThreadPool::ThreadPool(int num_threads) {
+  const int n = NumThreads(num_threads);
+  threads_.reserve(n);
+  for (int i = 0; i < n; i++) threads_.emplace_back([this] { Run(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::unique_lock lock(mutex_);
+    stopping_ = true;
+  }
+  ready_.notify_all();
+  for (std::thread& thread : threads_) thread.join();
+}
+
+void ThreadPool::Post(std::function<void()> task) {
+  {
+    std::unique_lock lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  ready_.notify_one();
+}
+
+void ThreadPool::Run() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock lock(mutex_);
+      ready_.wait(lock, [&] { return stopping_ || !tasks_.empty(); });
+      // Pending tasks are drained before the pool shuts down.
+      if (tasks_.empty()) return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void ParallelFor(int n, const std::function<void(int)>& f, int num_threads) {
+  const int k = std::min(n, NumThreads(num_threads));
+  if (k <= 1) {
+    for (int i = 0; i < n; i++) f(i);
+    return;
+  }
+  std::atomic<int> next = 0;
+  const auto worker = [&] {
+    while (true) {
+      const int i = next++;
+      if (i >= n) return;
+      f(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(k - 1);
+  for (int i = 1; i < k; i++) threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads) thread.join();
+}
+
+}  // namespace satisfactory
@@ -0,0 +1,50 @@
+#ifndef THREAD_POOL_HPP_
+#define THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace satisfactory {
+
+// A fixed-size pool of worker threads which execute posted tasks in FIFO order.
+// Destroying the pool waits for all posted tasks to complete.
+class ThreadPool {
+ public:
+  // Creates a pool with the given number of threads. A non-positive value
+  // selects one thread per hardware thread.
+  explicit ThreadPool(int num_threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int size() const noexcept { return threads_.size(); }
+
+  void Post(std::function<void()> task);
+
+ private:
+  void Run();
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopping_ = false;
+  std::vector<std::thread> threads_;
+};
+
+// Returns the number of threads that num_threads selects: itself if positive,
+// or else one per hardware thread.
+int NumThreads(int num_threads);
+
+// Invokes f(i) for each i in [0, n), distributing the calls across up to
+// num_threads threads. Returns once every call has completed.
+void ParallelFor(int n, const std::function<void(int)>& f,
+                 int num_threads = 0);
+
+}  // namespace satisfactory
+
+#endif  // THREAD_POOL_HPP_
@@ -0,0 +1,99 @@
+#include "trace.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace satisfactory::trace_internal {
+namespace {
+
+struct Event {
+  const char* name;
+  Clock::time_point start, end;
+};
+
+// The events of one thread. Each thread appends to its own buffer, so the lock
+// is only contended while the trace is being written.
+struct ThreadEvents {
+  int thread_id;
+  std::mutex mutex;
+  std::vector<Event> events;
+};
+
+struct Registry {
+  std::mutex mutex;
+  Clock::time_point start;
+  // Buffers are shared with their threads so that the events of threads which
+  // have exited are kept.
+  std::vector<std::shared_ptr<ThreadEvents>> threads;
+};
+
+Registry& GetRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+std::shared_ptr<ThreadEvents> RegisterThread() {
+  Registry& registry = GetRegistry();
+  std::unique_lock lock(registry.mutex);
+  auto events = std::make_shared<ThreadEvents>();
+  events->thread_id = registry.threads.size() + 1;
+  registry.threads.push_back(events);
+  return events;
+}
+
+}  // namespace
+
+void Record(const char* name, Clock::time_point start, Clock::time_point end) {
+  thread_local const std::shared_ptr<ThreadEvents> thread = RegisterThread();
+  std::unique_lock lock(thread->mutex);
+  thread->events.push_back({.name = name, .start = start, .end = end});
+}
+
+}  // namespace satisfactory::trace_internal
+
+namespace satisfactory {
+
+void StartTracing() {
+  trace_internal::Registry& registry = trace_internal::GetRegistry();
+  {
+    std::unique_lock lock(registry.mutex);
+    if (trace_internal::enabled) return;
+    registry.start = trace_internal::Clock::now();
+  }
+  trace_internal::enabled = true;
+}
+
+bool WriteTrace(const std::filesystem::path& path) {
+  trace_internal::Registry& registry = trace_internal::GetRegistry();
+  std::ofstream file(path);
+  if (!file) {
+    std::cerr << "Failed to write trace: " << path.string() << '\n';
+    return false;
+  }
+  const auto microseconds = [](trace_internal::Clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  };
+  file << std::fixed << std::setprecision(3)
+       << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  std::unique_lock lock(registry.mutex);
+  for (const auto& thread : registry.threads) {
+    std::unique_lock thread_lock(thread->mutex);
+    for (const trace_internal::Event& event : thread->events) {
+      // Span names are string literals, so they need no escaping.
+      file << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name
+           << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->thread_id
+           << ",\"ts\":" << microseconds(event.start - registry.start)
+           << ",\"dur\":" << microseconds(event.end - event.start) << '}';
+      first = false;
+    }
+  }
+  file << "\n]}\n";
+  return bool(file);
+}
+
+}  // namespace satisfactory
@@ -0,0 +1,62 @@
+#ifndef TRACE_HPP_
+#define TRACE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+
+namespace satisfactory {
+
+// A timeline of scoped spans across all threads, written in the Chrome trace
+// event format that chrome://tracing and Perfetto can load. Tracing is off
+// until StartTracing is called. While it is off, a span costs a single relaxed
+// atomic load, so spans can be left in performance-sensitive code.
+
+namespace trace_internal {
+
+using Clock = std::chrono::steady_clock;
+
+inline std::atomic<bool> enabled = false;
+
+void Record(const char* name, Clock::time_point start, Clock::time_point end);
+
+}  // namespace trace_internal
+
+inline bool TracingEnabled() noexcept {
+  return trace_internal::enabled.load(std::memory_order_relaxed);
+}
+
+// Starts recording spans. Timestamps are relative to the first call.
+void StartTracing();
+
+// Writes all of the spans recorded so far to a JSON file. Returns false if the
+// file could not be written.
+bool WriteTrace(const std::filesystem::path& path);
+
+// Records the time between its construction and destruction as a span. The
+// name must outlive the trace, which is the case for string literals. A span
+// which is not sampled is not recorded, which allows hot loops to trace only
+// some of their iterations.
+class TraceSpan {
+ public:
+  explicit TraceSpan(const char* name, bool sampled = true) noexcept
+      : name_(sampled && TracingEnabled() ? name : nullptr) {
+    if (name_) start_ = trace_internal::Clock::now();
+  }
+  ~TraceSpan() {
+    if (name_) {
+      trace_internal::Record(name_, start_, trace_internal::Clock::now());
+    }
+  }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+ private:
+  const char* name_;
+  trace_internal::Clock::time_point start_;
+};
+
+}  // namespace satisfactory
+
+#endif  // TRACE_HPP_